@@ -0,0 +1,127 @@
+#ifndef AOC_IDAY_H
+#define AOC_IDAY_H
+
+#include <cstdint>	   // For int64_t
+#include <iostream>	   // For std::cerr
+#include <ostream>	   // For std::ostream (SelfCheck logs)
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view
+#include <vector>	   // For std::vector
+
+#include "mapped-file.h"	 // For MappedFile (LoadFile's default)
+#include "partial-result.h"	 // For PartialResult (sharded runs)
+#include "prefetch-reader.h" // For PrefetchBackend
+
+// How LoadFile reads an input file; solvers ignore what they don't support.
+struct LoadOptions
+{
+	// Read the parsed input from a binary cache next to the file when one is
+	// fresh, and write one otherwise (see column-cache.h)
+	bool cache = false;
+	// Read through a PrefetchReader and parse block by block while later
+	// reads are in flight, instead of mapping the file
+	bool prefetch = false;
+	PrefetchBackend prefetchBackend = PrefetchBackend::Auto;
+};
+
+/**
+ * @brief Interface shared by every day's solver.
+ * A solver can be handed its puzzle input up front with Load() (the runner
+ * maps each input once and passes the text in); if it isn't, PartOne() reads
+ * the day's default input file itself. The parts return their answers and
+ * print nothing, so solvers can be driven as a library; printing is left to
+ * the caller (see reporter.h).
+ */
+class IDay
+{
+public:
+	// Virtual destructor: essential for proper cleanup of derived class objects
+	virtual ~IDay() = default;
+
+	/**
+	 * @brief Parses the puzzle input from memory. The text only needs to stay
+	 * alive for the duration of the call.
+	 * @return false if the input is malformed. What counts as malformed is
+	 * the day's to say: Day 1 stops at the first line without two integers
+	 * and fails, while Day 2 takes any text, one report per line.
+	 */
+	virtual bool Load(std::string_view input) = 0;
+
+	/**
+	 * @brief Loads the puzzle input file at 'path', as 'load' asks where the
+	 * solver supports it. The default just maps the file and calls Load().
+	 * @return false if the file can't be read or is malformed.
+	 */
+	virtual bool LoadFile(const std::string &path, const LoadOptions &load)
+	{
+		(void)load;
+		MappedFile input(path);
+		if (!input.IsOpen())
+		{
+			std::cerr << "ERROR: Unable to open file at path: " << path
+					  << std::endl;
+			return false;
+		}
+		return Load(input.View());
+	}
+
+	// Pure virtual functions: must be implemented by derived classes. Each
+	// returns that part's answer.
+	virtual int64_t PartOne() = 0;
+	virtual int64_t PartTwo() = 0;
+
+	/**
+	 * @brief Both answers at once, for callers that want both parts. Days
+	 * whose parts share work (Day 1's sort) override it to do that work once.
+	 * @return false if the input couldn't be read.
+	 */
+	virtual bool Solve(int64_t &part1, int64_t &part2)
+	{
+		part1 = PartOne();
+		part2 = PartTwo();
+		return true;
+	}
+
+	/**
+	 * @brief Map step of a sharded run: the loaded input's share of the
+	 * answers of a dataset split over several inputs. The default suits days
+	 * whose answers add up across shards, as Day 2's report counts do.
+	 */
+	virtual PartialResult Map()
+	{
+		PartialResult partial;
+		partial.sums[0] = PartOne();
+		partial.sums[1] = PartTwo();
+		return partial;
+	}
+
+	/**
+	 * @brief Combine step: both answers of the whole dataset from its shards'
+	 * partial results, which may come in any order. Needs no loaded input.
+	 */
+	virtual void Combine(const std::vector<PartialResult> &partials,
+						 int64_t &part1, int64_t &part2)
+	{
+		part1 = part2 = 0;
+		for (const PartialResult &partial : partials)
+		{
+			part1 += partial.sums[0];
+			part2 += partial.sums[1];
+		}
+	}
+
+	/**
+	 * @brief Differential check: solves 'input' with every fast path the
+	 * solver has and with its reference implementations, and describes each
+	 * disagreement on 'log'. Any text is valid input, malformed or not.
+	 * @return false if any path disagreed with the reference.
+	 */
+	virtual bool SelfCheck(std::string_view input, std::ostream &log)
+	{
+		(void)input;
+		(void)log;
+		return true;
+	}
+};
+
+#endif // AOC_IDAY_H
@@ -0,0 +1,36 @@
+#ifndef AOC_ARENA_H
+#define AOC_ARENA_H
+
+#include <cstddef>		   // For std::size_t, std::byte
+#include <memory_resource> // For std::pmr::monotonic_buffer_resource
+
+/**
+ * @brief Bump allocator for short-lived scratch buffers, usable with any
+ * std::pmr container. Allocations come from an inline buffer of InlineBytes
+ * first and only reach the heap (in growing blocks) once that is used up.
+ * Deallocation is a no-op; Reset() frees everything at once, so a batch of
+ * temporaries costs a few pointer bumps instead of a malloc/free each.
+ *
+ * Not thread-safe: give each thread its own arena (e.g. thread_local).
+ */
+template <std::size_t InlineBytes = 4096>
+class ScratchArena
+{
+public:
+	ScratchArena() : resource(buffer, sizeof(buffer)) {}
+
+	ScratchArena(const ScratchArena &) = delete;
+	ScratchArena &operator=(const ScratchArena &) = delete;
+
+	std::pmr::memory_resource *Resource() { return &resource; }
+
+	// Invalidates every allocation made since the last Reset(). Any heap
+	// blocks are returned; the inline buffer is reused as-is.
+	void Reset() { resource.release(); }
+
+private:
+	alignas(std::max_align_t) std::byte buffer[InlineBytes];
+	std::pmr::monotonic_buffer_resource resource;
+};
+
+#endif // AOC_ARENA_H
@@ -0,0 +1,424 @@
+// Micro-benchmarks for the Day 1 and Day 2 hot paths.
+//
+// Build (from Cpp/):
+//   g++ -std=c++17 -O2 -pthread bench.cpp -o bench
+//
+// The day files are compiled into this translation unit (with their main()
+// left out), so the benchmarks call exactly the code the solvers run. Each
+// benchmark repeats until it has run for --min-time seconds and reports the
+// median iteration with its throughput in lines/s and bytes/s.
+//
+// Usage: bench [--lines 1000000,10000000] [--filter text] [--min-time s]
+//              [--no-files]
+// --lines sets the synthetic input sizes (10^9 lines needs ~20 GB of RAM).
+
+#define AOC_RUNNER
+#include "day-01.cpp"
+#include "day-02.cpp"
+
+#include <algorithm>  // For std::sort
+#include <chrono>	  // For std::chrono::steady_clock
+#include <cstdio>	  // For std::printf
+#include <filesystem> // For std::filesystem::temp_directory_path, remove
+#include <fstream>	  // For std::ofstream (synthetic input files)
+#include <functional> // For std::function
+#include <map>		  // For std::map (the original counts2)
+
+#include "synthetic-input.h" // For synthetic::Day1Text, Day2Text
+
+namespace
+{
+struct BenchConfig
+{
+	std::vector<std::size_t> lines{1000000};
+	std::string filter;
+	double minTime = 0.2;
+	bool files = true; // Also run on the bundled inputs/
+};
+
+BenchConfig config;
+
+// Keeps results observable so the optimiser can't drop the work.
+volatile int64_t sink = 0;
+
+/**
+ * @brief Times body() (after an untimed setup() per iteration) until minTime
+ * has passed, then prints the median time and throughput.
+ */
+void Run(const std::string &name, std::size_t lines, std::size_t bytes,
+		 const std::function<void()> &setup, const std::function<void()> &body)
+{
+	if (!config.filter.empty() && name.find(config.filter) == std::string::npos)
+	{
+		return;
+	}
+	using Clock = std::chrono::steady_clock;
+	std::vector<double> samples;
+	double total = 0;
+	while (samples.size() < 3 || (total < config.minTime && samples.size() < 1000))
+	{
+		setup();
+		auto start = Clock::now();
+		body();
+		double seconds =
+			std::chrono::duration<double>(Clock::now() - start).count();
+		samples.push_back(seconds);
+		total += seconds;
+	}
+	std::sort(samples.begin(), samples.end());
+	double median = samples[samples.size() / 2];
+	std::printf("%-44s %10.3f ms %10.2f Mlines/s %10.1f MB/s  (n=%zu)\n",
+				name.c_str(), median * 1e3, lines / median / 1e6,
+				bytes / median / 1e6, samples.size());
+}
+
+void Run(const std::string &name, std::size_t lines, std::size_t bytes,
+		 const std::function<void()> &body)
+{
+	Run(name, lines, bytes, [] {}, body);
+}
+
+std::size_t CountLines(std::string_view text)
+{
+	std::size_t lines = 0;
+	ForEachLine(text, [&](std::string_view line) { lines += !line.empty(); });
+	return lines;
+}
+
+void BenchDay1(const std::string &label, const std::string &path)
+{
+	MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		std::printf("%s: cannot open %s\n", label.c_str(), path.c_str());
+		return;
+	}
+	const std::string prefix = "day1/" + label + "/";
+	const std::size_t bytes = file.Size();
+	const std::size_t lines = CountLines(file.View());
+
+	// ReadFileData: map the file and parse both columns
+	Run(prefix + "load", lines, bytes,
+		[&]
+		{
+			MappedFile input(path);
+			Day1 solver;
+			solver.Load(input.View());
+		});
+
+	for (ParseBackend backend : kParseBackends)
+	{
+		if (!ParseBackendSupported(backend))
+		{
+			continue;
+		}
+		IntParser parse = SelectIntParser(backend);
+		std::vector<int32_t> left, right;
+		Run(prefix + "parse/" + ParseBackendName(backend), lines, bytes,
+			[&]
+			{
+				left.clear();
+				right.clear();
+			},
+			[&] { ParseColumns(file.View(), parse, left, right); });
+	}
+	{
+		IntParser parse = SelectIntParser(ParseBackend::Auto);
+		std::vector<int32_t> left, right;
+		Run(prefix + "parse/fixed-width", lines, bytes,
+			[&]
+			{
+				left.clear();
+				right.clear();
+			},
+			[&] { ParseColumnsShaped(file.View(), parse, left, right); });
+	}
+
+	std::vector<int32_t> left, right;
+	ParseColumns(file.View(), SelectIntParser(ParseBackend::Auto), left, right);
+
+	for (SortBackend backend : {SortBackend::Std, SortBackend::Radix})
+	{
+		std::vector<int32_t> keys;
+		Run(prefix + (backend == SortBackend::Std ? "sort/std" : "sort/radix"),
+			lines, bytes, [&] { keys = left; },
+			[&] { SortColumn(keys, backend); });
+	}
+	{
+		// The compact layout's counting sort over 17-bit keys
+		PackedColumn keys;
+		Run(prefix + "sort/packed", lines, bytes,
+			[&]
+			{
+				keys.Clear();
+				keys.Append(left.data(), left.size());
+			},
+			[&] { SortPackedColumn(keys); });
+	}
+
+	// counts2: build the counting structure over list2, then look up list1
+	Run(prefix + "counts2/map", lines, bytes,
+		[&]
+		{
+			std::map<int32_t, int> counts2;
+			for (int32_t n : right)
+			{
+				counts2[n]++;
+			}
+			int64_t total = 0;
+			for (int32_t i : left)
+			{
+				total += int64_t(i) * counts2[i];
+			}
+			sink = total;
+		});
+	Run(prefix + "counts2/histogram", lines, bytes,
+		[&]
+		{
+			ValueCounter counts2(right);
+			int64_t total = 0;
+			for (int32_t i : left)
+			{
+				total += int64_t(i) * counts2.Count(i);
+			}
+			sink = total;
+		});
+	PackedColumn packedLeft, packedRight;
+	packedLeft.Append(left.data(), left.size());
+	packedRight.Append(right.data(), right.size());
+	int64_t counted = 0;
+	if (PackedSimilarityCounted(packedLeft, packedRight, counted))
+	{
+		Run(prefix + "counts2/packed", lines, bytes,
+			[&]
+			{
+				int64_t total = 0;
+				PackedSimilarityCounted(packedLeft, packedRight, total);
+				sink = total;
+			});
+	}
+	else
+	{
+		// Too wide a range to count densely: time what --compact does then,
+		// sorting both columns and merging them
+		std::printf("%scounts2/packed: range too wide to count, timing the "
+					"sort + merge fallback\n",
+					prefix.c_str());
+		PackedColumn sortedPackedLeft, sortedPackedRight;
+		Run(prefix + "counts2/packed-sorted", lines, bytes,
+			[&]
+			{
+				sortedPackedLeft = packedLeft;
+				sortedPackedRight = packedRight;
+			},
+			[&]
+			{
+				SortPackedColumn(sortedPackedLeft);
+				SortPackedColumn(sortedPackedRight);
+				sink = PackedSimilaritySorted(sortedPackedLeft,
+											  sortedPackedRight);
+			});
+	}
+	std::vector<int32_t> sortedLeft = left, sortedRight = right;
+	std::sort(sortedLeft.begin(), sortedLeft.end());
+	std::sort(sortedRight.begin(), sortedRight.end());
+	Run(prefix + "counts2/merge", lines, bytes,
+		[&] { sink = SimilarityFromSorted(sortedLeft, sortedRight); });
+
+	// Both parts on a loaded solver: PartOne then PartTwo, then Solve
+	std::unique_ptr<Day1> solver;
+	auto load = [&]
+	{
+		solver = std::make_unique<Day1>();
+		solver->Load(file.View());
+	};
+	Run(prefix + "parts/separate", lines, bytes, load,
+		[&] { sink = solver->PartOne() + solver->PartTwo(); });
+	Run(prefix + "parts/solve", lines, bytes, load,
+		[&]
+		{
+			Day1Answers answers;
+			solver->Solve(answers);
+			sink = answers.distance + answers.similarity;
+		});
+}
+
+void BenchDay2(const std::string &label, const std::string &path)
+{
+	MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		std::printf("%s: cannot open %s\n", label.c_str(), path.c_str());
+		return;
+	}
+	const std::string prefix = "day2/" + label + "/";
+	const std::size_t bytes = file.Size();
+	const std::size_t lines = CountLines(file.View());
+
+	Run(prefix + "load", lines, bytes,
+		[&]
+		{
+			ReportTable table;
+			GetVectorIntsFromTxt(path, table);
+			sink = static_cast<int64_t>(table.Count());
+		});
+
+	for (ParseBackend backend : kParseBackends)
+	{
+		if (!ParseBackendSupported(backend))
+		{
+			continue;
+		}
+		std::vector<int> numbers;
+		Run(prefix + "parse/" + ParseBackendName(backend), lines, bytes,
+			[&]
+			{
+				ForEachLine(file.View(),
+							[&](std::string_view line)
+							{
+								numbers.clear();
+								DelimitedToInts(line, numbers, backend);
+							});
+				sink = static_cast<int64_t>(numbers.size());
+			});
+	}
+
+	ReportTable table = ReportsFromText(file.View());
+	Run(prefix + "safe/per-report", lines, bytes,
+		[&]
+		{
+			table.Visit(
+				[&](const auto &reports)
+				{
+					int64_t safe = 0;
+					for (std::size_t r = 0; r < reports.Count(); r++)
+					{
+						safe += IsSafeReport(reports[r].data(), reports[r].size());
+					}
+					sink = safe;
+				});
+		});
+	Run(prefix + "safe/fixed-shape", lines, bytes,
+		[&]
+		{
+			table.Visit(
+				[&](const auto &reports)
+				{
+					int64_t safe = 0;
+					for (std::size_t r = 0; r < reports.Count(); r++)
+					{
+						safe += IsSafeShaped(reports[r].data(), reports[r].size());
+					}
+					sink = safe;
+				});
+		});
+	SafeMask mask;
+	Run(prefix + "safe/batched", lines, bytes,
+		[&]
+		{
+			table.Visit([&](const auto &reports)
+						{ ClassifyBatched(reports, mask); });
+			sink = static_cast<int64_t>(mask.CountSet());
+		});
+
+	// Part 2 removal loop, on reports already loaded into the solver
+	for (DampenerMode mode : {DampenerMode::Exhaustive, DampenerMode::SinglePass})
+	{
+		Day2Options options;
+		options.dampener = mode;
+		std::unique_ptr<Day2> solver;
+		Run(prefix + (mode == DampenerMode::Exhaustive ? "dampener/exhaustive"
+													   : "dampener/single-pass"),
+			lines, bytes,
+			[&]
+			{
+				solver = std::make_unique<Day2>(options);
+				solver->Load(file.View());
+			},
+			[&] { sink = solver->PartTwo(); });
+	}
+}
+
+// Writes 'text' to a temporary file for the load benchmarks.
+std::string WriteTemp(const std::string &name, const std::string &text)
+{
+	std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream out(path, std::ios::binary);
+	out.write(text.data(), static_cast<std::streamsize>(text.size()));
+	return path;
+}
+
+bool ParseSizes(std::string_view text, std::vector<std::size_t> &sizes)
+{
+	sizes.clear();
+	while (!text.empty())
+	{
+		std::size_t comma = text.find(',');
+		std::string_view item = text.substr(0, comma);
+		std::size_t value = 0;
+		if (std::from_chars(item.data(), item.data() + item.size(), value).ec !=
+				std::errc() ||
+			value == 0)
+		{
+			return false;
+		}
+		sizes.push_back(value);
+		text.remove_prefix(comma == std::string_view::npos ? text.size()
+														   : comma + 1);
+	}
+	return !sizes.empty();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		std::string_view value = i + 1 < argc ? argv[i + 1] : "";
+		if (arg == "--lines" && ParseSizes(value, config.lines))
+		{
+			i++;
+		}
+		else if (arg == "--filter" && !value.empty())
+		{
+			config.filter = value;
+			i++;
+		}
+		else if (arg == "--min-time" && !value.empty())
+		{
+			config.minTime = std::atof(argv[++i]);
+		}
+		else if (arg == "--no-files")
+		{
+			config.files = false;
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0]
+					  << " [--lines n[,n...]] [--filter text] [--min-time s]"
+						 " [--no-files]"
+					  << std::endl;
+			return 1;
+		}
+	}
+
+	if (config.files)
+	{
+		BenchDay1("input", "../inputs/input-01.txt");
+		BenchDay2("input", "../inputs/input-02.txt");
+	}
+	for (std::size_t lines : config.lines)
+	{
+		std::string label = "synthetic-" + std::to_string(lines);
+		std::string path1 = WriteTemp("aoc-bench-day1.txt",
+									  synthetic::Day1Text(lines));
+		BenchDay1(label, path1);
+		std::filesystem::remove(path1);
+		std::string path2 = WriteTemp("aoc-bench-day2.txt",
+									  synthetic::Day2Text(lines));
+		BenchDay2(label, path2);
+		std::filesystem::remove(path2);
+	}
+	return 0;
+}
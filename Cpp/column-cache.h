@@ -0,0 +1,487 @@
+#ifndef AOC_COLUMN_CACHE_H
+#define AOC_COLUMN_CACHE_H
+
+#include <chrono>		// For std::chrono::nanoseconds (mtimes)
+#include <cstddef>		// For std::size_t
+#include <cstdint>		// For uint32_t, uint64_t, int64_t
+#include <cstdio>		// For std::FILE, std::fopen, std::fwrite
+#include <cstring>		// For std::memcpy, std::memcmp
+#include <filesystem>	// For std::filesystem::last_write_time, rename
+#include <iostream>		// For std::cerr
+#include <string>		// For std::string
+#include <system_error> // For std::error_code
+#include <vector>		// For std::vector
+
+#include "mapped-file.h" // For MappedFile (the cache is read in place)
+
+// Writers create their temporary file under a unique name where mkstemp is
+// available, so concurrent refreshes of one cache never share it.
+#if defined(__unix__) || defined(__APPLE__)
+#define AOC_HAVE_MKSTEMP 1
+#include <stdio.h>	  // For fdopen
+#include <stdlib.h>	  // For mkstemp
+#include <sys/stat.h> // For fchmod
+#include <unistd.h>	  // For close
+#else
+#define AOC_HAVE_MKSTEMP 0
+#endif
+
+/**
+ * Binary columnar cache of a parsed input, so repeat runs skip the text
+ * parser entirely.
+ *
+ * A cache file is a fixed header, a directory of column descriptors and the
+ * column payloads:
+ *
+ *   CacheHeader   magic, version, kind, flags, source size and mtime
+ *   ColumnInfo[]  encoding, bit width, count, base/origin, value range,
+ *                 offset, checksum
+ *   payloads      each column bit-packed at 'width' bits per value
+ *
+ * Every column is stored either Packed (value - base) or DeltaPacked
+ * (difference to the previous value - base); the writer picks whichever is
+ * smaller, so sorted columns and slowly varying levels shrink to a few bits
+ * per value. The header and every payload carry a checksum, and the header
+ * records the size and mtime of the text it was built from: a cache is only
+ * used while the source is unchanged and not newer than the cache. All
+ * integers are in host byte order; the header's byte-order mark rejects
+ * files written on a machine of the other endianness.
+ */
+
+// What a cache file holds, so one day never reads another's cache.
+enum class CacheKind : uint32_t
+{
+	Day1Columns = 1, // list1, list2
+	Day2Reports = 2, // report lengths, all levels
+};
+
+// Header flags.
+constexpr uint32_t kCacheSorted = 1; // Every column is sorted ascending
+
+enum class ColumnEncoding : uint32_t
+{
+	Packed = 0,		 // value - base
+	DeltaPacked = 1, // value - previous - base (origin is the first value)
+};
+
+struct CacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	CacheKind kind;
+	uint32_t flags;
+	uint32_t columns;
+	uint32_t reserved;
+	uint64_t sourceSize;
+	int64_t sourceMtime; // Nanoseconds since the filesystem clock's epoch
+	uint64_t checksum;	 // Of the header (with this field zeroed) and directory
+};
+
+struct ColumnInfo
+{
+	ColumnEncoding encoding;
+	uint32_t width; // Bits per value, 0..64
+	uint64_t count;
+	int64_t base;
+	int64_t origin;
+	int64_t minValue; // Range of the decoded values (0, 0 when empty)
+	int64_t maxValue;
+	uint64_t offset; // Payload position from the start of the file
+	uint64_t bytes;
+	uint64_t checksum;
+};
+
+// The on-disk layout; the sizes are part of the format.
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader layout changed");
+static_assert(sizeof(ColumnInfo) == 72, "ColumnInfo layout changed");
+
+constexpr char kCacheMagic[8] = {'A', 'O', 'C', 'C', 'O', 'L', 'S', '\0'};
+constexpr uint32_t kCacheVersion = 1;
+constexpr uint32_t kCacheByteOrder = 0x01020304;
+
+// Where the cache for 'source' lives.
+inline std::string ColumnCachePath(const std::string &source)
+{
+	return source + ".cache";
+}
+
+/**
+ * @brief 64-bit checksum of 'n' bytes, a word at a time: cheap enough to
+ * verify a whole cache on every load, and it catches truncation and bit rot.
+ */
+inline uint64_t CacheChecksum(const void *data, std::size_t n,
+							  uint64_t seed = 0x9E3779B97F4A7C15ULL)
+{
+	constexpr uint64_t kMul = 0xFF51AFD7ED558CCDULL;
+	const unsigned char *p = static_cast<const unsigned char *>(data);
+	uint64_t h = seed ^ (n * kMul);
+	for (; n >= 8; n -= 8, p += 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, p, 8);
+		h = (h ^ word) * kMul;
+		h ^= h >> 32;
+	}
+	uint64_t tail = 0;
+	std::memcpy(&tail, p, n);
+	h = (h ^ tail) * kMul;
+	return h ^ (h >> 29);
+}
+
+// Size and mtime of the text a cache is built from.
+struct CacheSource
+{
+	uint64_t size = 0;
+	int64_t mtime = 0;
+};
+
+inline bool StatCacheSource(const std::string &path, CacheSource &source)
+{
+	std::error_code ec;
+	uintmax_t size = std::filesystem::file_size(path, ec);
+	if (ec)
+	{
+		return false;
+	}
+	auto time = std::filesystem::last_write_time(path, ec);
+	if (ec)
+	{
+		return false;
+	}
+	source.size = static_cast<uint64_t>(size);
+	source.mtime = static_cast<int64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			time.time_since_epoch())
+			.count());
+	return true;
+}
+
+// Bits needed to hold 'range'.
+inline uint32_t BitWidth(uint64_t range)
+{
+	uint32_t bits = 0;
+	for (; range; range >>= 1)
+	{
+		bits++;
+	}
+	return bits;
+}
+
+/**
+ * @brief Collects columns and writes them as one cache file.
+ */
+class ColumnCacheWriter
+{
+public:
+	/**
+	 * @brief Adds a column, bit-packed with whichever encoding is smaller.
+	 */
+	template <typename T>
+	void AddColumn(const T *values, std::size_t count)
+	{
+		ColumnInfo info{};
+		info.count = count;
+		if (count > 0)
+		{
+			// Ranges of both encodings, found in one pass
+			int64_t lo = values[0], hi = values[0];
+			int64_t dlo = 0, dhi = 0;
+			for (std::size_t i = 1; i < count; i++)
+			{
+				int64_t v = values[i];
+				int64_t d = v - static_cast<int64_t>(values[i - 1]);
+				lo = v < lo ? v : lo;
+				hi = v > hi ? v : hi;
+				dlo = i == 1 || d < dlo ? d : dlo;
+				dhi = i == 1 || d > dhi ? d : dhi;
+			}
+			uint32_t packed = BitWidth(static_cast<uint64_t>(hi - lo));
+			uint32_t delta = BitWidth(static_cast<uint64_t>(dhi - dlo));
+			info.origin = values[0];
+			info.minValue = lo;
+			info.maxValue = hi;
+			if (delta < packed)
+			{
+				info.encoding = ColumnEncoding::DeltaPacked;
+				info.width = delta;
+				info.base = dlo;
+			}
+			else
+			{
+				info.encoding = ColumnEncoding::Packed;
+				info.width = packed;
+				info.base = lo;
+			}
+		}
+
+		// One spare word at the end lets the reader always load 8 bytes
+		std::vector<uint64_t> words((count * info.width + 63) / 64 + 1, 0);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			int64_t v = values[i];
+			uint64_t stored =
+				info.encoding == ColumnEncoding::Packed
+					? static_cast<uint64_t>(v - info.base)
+				: i == 0
+					? 0
+					: static_cast<uint64_t>(
+						  v - static_cast<int64_t>(values[i - 1]) - info.base);
+			uint64_t bit = i * info.width;
+			if (info.width == 0)
+			{
+				continue;
+			}
+			words[bit / 64] |= stored << (bit % 64);
+			if (bit % 64 + info.width > 64)
+			{
+				words[bit / 64 + 1] |= stored >> (64 - bit % 64);
+			}
+		}
+		info.bytes = words.size() * sizeof(uint64_t);
+		info.checksum = CacheChecksum(words.data(), info.bytes);
+		columns.push_back(info);
+		payloads.push_back(std::move(words));
+	}
+
+	/**
+	 * @brief Writes the columns to 'path', via a uniquely named temporary
+	 * file renamed into place so a reader never sees a half-written cache and
+	 * concurrent writers never interleave.
+	 * @return false (with a message on std::cerr) if the file can't be written.
+	 */
+	bool Write(const std::string &path, CacheKind kind, uint32_t flags,
+			   const CacheSource &source)
+	{
+		CacheHeader header{};
+		std::memcpy(header.magic, kCacheMagic, sizeof(header.magic));
+		header.version = kCacheVersion;
+		header.byteOrder = kCacheByteOrder;
+		header.kind = kind;
+		header.flags = flags;
+		header.columns = static_cast<uint32_t>(columns.size());
+		header.sourceSize = source.size;
+		header.sourceMtime = source.mtime;
+
+		uint64_t offset =
+			sizeof(CacheHeader) + columns.size() * sizeof(ColumnInfo);
+		for (ColumnInfo &info : columns)
+		{
+			info.offset = offset;
+			offset += info.bytes;
+		}
+		header.checksum = HeaderChecksum(header, columns.data());
+
+		std::string temp;
+		std::FILE *out = OpenTemp(path, temp);
+		if (!out)
+		{
+			std::cerr << "Warning: Unable to write cache " << path << std::endl;
+			return false;
+		}
+		bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+				  (columns.empty() ||
+				   std::fwrite(columns.data(), sizeof(ColumnInfo),
+							   columns.size(), out) == columns.size());
+		for (const std::vector<uint64_t> &words : payloads)
+		{
+			ok = ok && std::fwrite(words.data(), sizeof(uint64_t), words.size(),
+								   out) == words.size();
+		}
+		ok = std::fclose(out) == 0 && ok;
+		std::error_code ec;
+		if (ok)
+		{
+			std::filesystem::rename(temp, path, ec);
+		}
+		if (!ok || ec)
+		{
+			std::filesystem::remove(temp, ec);
+			std::cerr << "Warning: Unable to write cache " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Creates a new temporary file next to 'path' and stores its name in
+	// 'temp'. Returns nullptr if it can't be created.
+	static std::FILE *OpenTemp(const std::string &path, std::string &temp)
+	{
+#if AOC_HAVE_MKSTEMP
+		temp = path + ".XXXXXX";
+		int fd = mkstemp(&temp[0]);
+		if (fd < 0)
+		{
+			return nullptr;
+		}
+		// mkstemp creates the file owner-only; give the cache the usual
+		// 0644 instead
+		fchmod(fd, 0644);
+		std::FILE *out = fdopen(fd, "wb");
+		if (!out)
+		{
+			close(fd);
+			std::error_code ec;
+			std::filesystem::remove(temp, ec);
+		}
+		return out;
+#else
+		temp = path + ".tmp";
+		return std::fopen(temp.c_str(), "wb");
+#endif
+	}
+
+	static uint64_t HeaderChecksum(CacheHeader header, const ColumnInfo *infos)
+	{
+		header.checksum = 0;
+		return CacheChecksum(infos, header.columns * sizeof(ColumnInfo),
+							 CacheChecksum(&header, sizeof(header)));
+	}
+
+private:
+	std::vector<ColumnInfo> columns;
+	std::vector<std::vector<uint64_t>> payloads;
+};
+
+/**
+ * @brief A cache file mapped in place. Open() checks everything up front
+ * (format, kind, freshness against the source, checksums), so a cache that
+ * opens can always be decoded.
+ */
+class ColumnCache
+{
+public:
+	/**
+	 * @brief Maps the cache at 'path' if it holds 'kind' and was built from
+	 * 'source' as it is now.
+	 * @return false if the cache is missing, stale or damaged; the caller then
+	 * parses the text (and usually rewrites the cache).
+	 */
+	bool Open(const std::string &path, CacheKind kind,
+			  const CacheSource &source)
+	{
+		CacheSource self;
+		if (!StatCacheSource(path, self) || self.mtime < source.mtime ||
+			!file.Open(path))
+		{
+			return false;
+		}
+		std::string_view bytes = file.View();
+		if (bytes.size() < sizeof(CacheHeader))
+		{
+			return false;
+		}
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+			header.version != kCacheVersion ||
+			header.byteOrder != kCacheByteOrder || header.kind != kind ||
+			header.sourceSize != source.size ||
+			header.sourceMtime != source.mtime ||
+			(bytes.size() - sizeof(CacheHeader)) / sizeof(ColumnInfo) <
+				header.columns)
+		{
+			return false;
+		}
+		columns.resize(header.columns);
+		std::memcpy(columns.data(), bytes.data() + sizeof(CacheHeader),
+					columns.size() * sizeof(ColumnInfo));
+		if (ColumnCacheWriter::HeaderChecksum(header, columns.data()) !=
+			header.checksum)
+		{
+			return false;
+		}
+		for (const ColumnInfo &info : columns)
+		{
+			if (info.width > 64 || info.offset > bytes.size() ||
+				bytes.size() - info.offset < info.bytes ||
+				info.bytes < ((info.count * info.width + 63) / 64 + 1) * 8 ||
+				CacheChecksum(bytes.data() + info.offset, info.bytes) !=
+					info.checksum)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::size_t Columns() const { return columns.size(); }
+	// Smallest and largest value of column 'index', to pick a type to decode
+	// it into.
+	int64_t MinValue(std::size_t index) const { return columns[index].minValue; }
+	int64_t MaxValue(std::size_t index) const { return columns[index].maxValue; }
+	bool Sorted() const { return header.flags & kCacheSorted; }
+
+	/**
+	 * @brief Unpacks column 'index' into 'out' (replacing its contents).
+	 */
+	template <typename T>
+	void Decode(std::size_t index, std::vector<T> &out) const
+	{
+		const ColumnInfo &info = columns[index];
+		out.resize(info.count);
+		// Up to 57 bits, every value sits inside one unaligned 8-byte load;
+		// wider ones may straddle two words.
+		if (info.width <= 57)
+		{
+			Unpack(info, out.data(),
+				   [&](uint64_t word, uint64_t bit)
+				   { return word >> (bit % 8); });
+		}
+		else
+		{
+			const char *payload = file.View().data() + info.offset;
+			Unpack(info, out.data(),
+				   [&](uint64_t, uint64_t bit)
+				   {
+					   // A word-aligned value is "lo" alone: shifting "hi" by
+					   // 64 would be undefined
+					   uint64_t lo, hi;
+					   std::memcpy(&lo, payload + bit / 64 * 8, 8);
+					   std::memcpy(&hi, payload + bit / 64 * 8 + 8, 8);
+					   return bit % 64 == 0
+								  ? lo
+								  : (lo >> (bit % 64)) | (hi << (64 - bit % 64));
+				   });
+		}
+	}
+
+private:
+	MappedFile file;
+	CacheHeader header{};
+	std::vector<ColumnInfo> columns;
+
+	// Decodes every value of 'info' into 'out'; extract(word, bit) returns
+	// the stored value starting at 'bit' (in its low bits), given the 8 bytes
+	// loaded from bit / 8. The encoding is resolved once, outside the loops.
+	template <typename T, typename Extract>
+	void Unpack(const ColumnInfo &info, T *out, Extract &&extract) const
+	{
+		const char *payload = file.View().data() + info.offset;
+		const uint64_t width = info.width;
+		const uint64_t mask = width == 64 ? ~uint64_t(0)
+										  : (uint64_t(1) << width) - 1;
+		auto stored = [&](std::size_t i)
+		{
+			uint64_t bit = i * width;
+			uint64_t word;
+			std::memcpy(&word, payload + bit / 8, 8);
+			return static_cast<int64_t>(extract(word, bit) & mask);
+		};
+		if (info.encoding == ColumnEncoding::Packed)
+		{
+			for (std::size_t i = 0; i < info.count; i++)
+			{
+				out[i] = static_cast<T>(info.base + stored(i));
+			}
+			return;
+		}
+		int64_t value = info.origin;
+		for (std::size_t i = 0; i < info.count; i++)
+		{
+			value += i == 0 ? 0 : info.base + stored(i);
+			out[i] = static_cast<T>(value);
+		}
+	}
+};
+
+#endif // AOC_COLUMN_CACHE_H
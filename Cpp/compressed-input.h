@@ -0,0 +1,648 @@
+#ifndef AOC_COMPRESSED_INPUT_H
+#define AOC_COMPRESSED_INPUT_H
+
+#include <algorithm>   // For std::min
+#include <cstddef>	   // For std::size_t
+#include <cstdint>	   // For uint8_t, uint32_t, uint64_t
+#include <cstdio>	   // For std::FILE, std::fopen, std::fread, std::fseek
+#include <cstring>	   // For std::memcpy, std::memmove
+#include <filesystem>  // For std::filesystem::status
+#include <iostream>	   // For std::cerr
+#include <memory>	   // For std::unique_ptr
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view
+#include <vector>	   // For std::vector
+
+#include "line-stream.h"	 // For ByteSource, StdioSource, ForEachLineBlock
+#include "mapped-file.h"	 // For MappedFile
+#include "prefetch-reader.h" // For PrefetchReader, PrefetchSource
+#include "profile.h"		 // For AOC_PROFILE_SCOPE
+#include "thread-pool.h"	 // For WorkStealingPool
+
+/**
+ * Streaming gzip and zstd decompression for the solver inputs.
+ *
+ * Compressed files are recognised by their magic bytes, not their name, and
+ * decompressed block by block straight into the parser's buffer, so there is
+ * no intermediate file and only compressed bytes are read from disk. A zstd
+ * file made of several independent frames (pzstd, or the seekable format) is
+ * instead decompressed one frame per task on the thread pool, a bounded
+ * window of frames at a time.
+ *
+ * The codecs are opt-in, as each needs its library linked:
+ *   -DAOC_ZLIB -lz       gzip (and zlib) streams
+ *   -DAOC_ZSTD -lzstd    zstd frames
+ * Without them a compressed input is reported as unsupported.
+ */
+
+#if defined(AOC_ZLIB) && __has_include(<zlib.h>)
+#include <zlib.h>
+#define AOC_HAVE_ZLIB 1
+#else
+#define AOC_HAVE_ZLIB 0
+#endif
+
+#if defined(AOC_ZSTD) && __has_include(<zstd.h>)
+#include <zstd.h>
+#define AOC_HAVE_ZSTD 1
+#else
+#define AOC_HAVE_ZSTD 0
+#endif
+
+enum class Compression
+{
+	None,
+	Gzip,
+	Zstd,
+};
+
+inline const char *CompressionName(Compression compression)
+{
+	switch (compression)
+	{
+	case Compression::Gzip:
+		return "gzip";
+	case Compression::Zstd:
+		return "zstd";
+	default:
+		return "none";
+	}
+}
+
+// Recognises a stream from its first (up to) 4 bytes.
+inline Compression DetectCompression(const unsigned char *head, std::size_t n)
+{
+	if (n >= 2 && head[0] == 0x1f && head[1] == 0x8b)
+	{
+		return Compression::Gzip;
+	}
+	if (n >= 4 && head[0] == 0x28 && head[1] == 0xb5 && head[2] == 0x2f &&
+		head[3] == 0xfd)
+	{
+		return Compression::Zstd;
+	}
+	return Compression::None;
+}
+
+/**
+ * @brief True if 'path' exists but is not a regular file: a FIFO, /dev/stdin,
+ * a process substitution. Those can only be read once, front to back, so
+ * they go through ReadStreamBlocks rather than being sniffed, sized or
+ * mapped first.
+ */
+inline bool IsStreamOnly(const std::string &path)
+{
+	std::error_code error;
+	std::filesystem::file_status status = std::filesystem::status(path, error);
+	return !error && std::filesystem::exists(status) &&
+		   !std::filesystem::is_regular_file(status);
+}
+
+// Compression of the file at 'path'; None if it is plain or unreadable.
+// Only regular files are sniffed: opening a pipe to peek at it would eat the
+// head of the stream (see IsStreamOnly).
+inline Compression FileCompression(const std::string &path)
+{
+	if (IsStreamOnly(path))
+	{
+		return Compression::None;
+	}
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		return Compression::None;
+	}
+	unsigned char head[4];
+	std::size_t n = std::fread(head, 1, sizeof(head), file);
+	std::fclose(file);
+	return DetectCompression(head, n);
+}
+
+inline bool CompressionSupported(Compression compression)
+{
+	return compression == Compression::None ||
+		   (compression == Compression::Gzip && AOC_HAVE_ZLIB) ||
+		   (compression == Compression::Zstd && AOC_HAVE_ZSTD);
+}
+
+/**
+ * @brief ByteSource that reads the first bytes of 'upstream' up front, so a
+ * stream that cannot seek (a pipe, stdin) can be sniffed with Detect() and
+ * then still be read from its start.
+ */
+class PeekedSource : public ByteSource
+{
+public:
+	explicit PeekedSource(ByteSource &upstream) : upstream(upstream)
+	{
+		while (size < sizeof(head))
+		{
+			std::size_t got = upstream.Read(
+				reinterpret_cast<char *>(head) + size, sizeof(head) - size);
+			if (got == 0)
+			{
+				break;
+			}
+			size += got;
+		}
+	}
+
+	Compression Detect() const { return DetectCompression(head, size); }
+
+	std::size_t Read(char *dst, std::size_t capacity) override
+	{
+		if (pos == size)
+		{
+			return upstream.Read(dst, capacity);
+		}
+		std::size_t n = size - pos < capacity ? size - pos : capacity;
+		std::memcpy(dst, head + pos, n);
+		pos += n;
+		return n;
+	}
+
+	bool Failed() const override { return upstream.Failed(); }
+
+private:
+	ByteSource &upstream;
+	unsigned char head[4];
+	std::size_t size = 0;
+	std::size_t pos = 0;
+};
+
+namespace compressed_detail
+{
+// Input buffer size for the streaming decompressors
+constexpr std::size_t kInputBytes = std::size_t(1) << 18;
+} // namespace compressed_detail
+
+#if AOC_HAVE_ZLIB
+/**
+ * @brief ByteSource that inflates a gzip (or zlib) stream pulled from
+ * 'upstream'. Concatenated gzip members, as written by `cat a.gz b.gz` or
+ * pigz, are decoded one after the other.
+ */
+class GzipSource : public ByteSource
+{
+public:
+	explicit GzipSource(ByteSource &upstream)
+		: upstream(upstream), input(compressed_detail::kInputBytes)
+	{
+		// 15 + 32: the largest window, with gzip/zlib header autodetection
+		failed = inflateInit2(&stream, 15 + 32) != Z_OK;
+		ready = !failed;
+	}
+
+	~GzipSource() override
+	{
+		if (ready)
+		{
+			inflateEnd(&stream);
+		}
+	}
+
+	GzipSource(const GzipSource &) = delete;
+	GzipSource &operator=(const GzipSource &) = delete;
+
+	std::size_t Read(char *dst, std::size_t capacity) override
+	{
+		AOC_PROFILE_SCOPE(Decompress);
+		stream.next_out = reinterpret_cast<Bytef *>(dst);
+		stream.avail_out = static_cast<uInt>(
+			capacity < std::size_t(UINT32_MAX) ? capacity : UINT32_MAX);
+		while (!failed && !done && stream.avail_out > 0)
+		{
+			if (stream.avail_in == 0 && !Refill())
+			{
+				// The stream ended before its trailer
+				failed = memberOpen || upstream.Failed();
+				done = true;
+				break;
+			}
+			int ret = inflate(&stream, Z_NO_FLUSH);
+			memberOpen = true;
+			if (ret == Z_STREAM_END)
+			{
+				// Another member may follow; anything else is an error
+				memberOpen = false;
+				if (inflateReset(&stream) != Z_OK)
+				{
+					failed = true;
+				}
+			}
+			else if (ret != Z_OK && ret != Z_BUF_ERROR)
+			{
+				failed = true;
+			}
+		}
+		return static_cast<std::size_t>(
+			reinterpret_cast<char *>(stream.next_out) - dst);
+	}
+
+	bool Failed() const override { return failed; }
+
+private:
+	ByteSource &upstream;
+	std::vector<char> input;
+	z_stream stream{};
+	bool ready = false;
+	bool failed = false;
+	bool done = false;
+	bool memberOpen = false;
+
+	bool Refill()
+	{
+		std::size_t got = upstream.Read(input.data(), input.size());
+		stream.next_in = reinterpret_cast<Bytef *>(input.data());
+		stream.avail_in = static_cast<uInt>(got);
+		return got > 0;
+	}
+};
+#endif // AOC_HAVE_ZLIB
+
+#if AOC_HAVE_ZSTD
+/**
+ * @brief ByteSource that decompresses zstd frames pulled from 'upstream'.
+ * Consecutive frames are decoded one after the other and skippable frames
+ * (e.g. a seek table) are passed over.
+ */
+class ZstdSource : public ByteSource
+{
+public:
+	explicit ZstdSource(ByteSource &upstream)
+		: upstream(upstream), input(compressed_detail::kInputBytes),
+		  stream(ZSTD_createDStream())
+	{
+		failed = !stream;
+	}
+
+	~ZstdSource() override { ZSTD_freeDStream(stream); }
+
+	ZstdSource(const ZstdSource &) = delete;
+	ZstdSource &operator=(const ZstdSource &) = delete;
+
+	std::size_t Read(char *dst, std::size_t capacity) override
+	{
+		AOC_PROFILE_SCOPE(Decompress);
+		ZSTD_outBuffer out = {dst, capacity, 0};
+		while (!failed && !done && out.pos < out.size)
+		{
+			if (in.pos == in.size)
+			{
+				std::size_t got = upstream.Read(input.data(), input.size());
+				if (got == 0)
+				{
+					// The stream ended in the middle of a frame
+					failed = frameOpen || upstream.Failed();
+					done = true;
+					break;
+				}
+				in = {input.data(), got, 0};
+			}
+			std::size_t ret = ZSTD_decompressStream(stream, &out, &in);
+			if (ZSTD_isError(ret))
+			{
+				failed = true;
+				break;
+			}
+			frameOpen = ret != 0;
+		}
+		return out.pos;
+	}
+
+	bool Failed() const override { return failed; }
+
+private:
+	ByteSource &upstream;
+	std::vector<char> input;
+	ZSTD_DStream *stream;
+	ZSTD_inBuffer in = {nullptr, 0, 0};
+	bool failed = false;
+	bool done = false;
+	bool frameOpen = false;
+};
+
+namespace compressed_detail
+{
+struct ZstdFrame
+{
+	std::string_view data; // The compressed frame
+	std::size_t output;	   // Where its content starts in the output
+	std::size_t size;	   // Decompressed size
+};
+
+/**
+ * @brief Splits a whole zstd file into its data frames and works out where
+ * each one's content lands. Fails (returns false) unless every frame is
+ * well-formed and records its content size, which pzstd and zstd always do
+ * for files.
+ */
+inline bool SplitZstdFrames(std::string_view file,
+							std::vector<ZstdFrame> &frames, std::size_t &total)
+{
+	frames.clear();
+	total = 0;
+	while (!file.empty())
+	{
+		std::size_t bytes = ZSTD_findFrameCompressedSize(file.data(), file.size());
+		if (ZSTD_isError(bytes) || bytes == 0)
+		{
+			return false;
+		}
+		// Skippable frames use the magic numbers 0x184D2A50 to 0x184D2A5F
+		uint32_t magic = 0;
+		for (int i = 3; i >= 0 && file.size() >= 4; i--)
+		{
+			magic = (magic << 8) | static_cast<uint8_t>(file[i]);
+		}
+		if ((magic & 0xFFFFFFF0u) != 0x184D2A50u)
+		{
+			unsigned long long size =
+				ZSTD_getFrameContentSize(file.data(), file.size());
+			if (size == ZSTD_CONTENTSIZE_UNKNOWN ||
+				size == ZSTD_CONTENTSIZE_ERROR)
+			{
+				return false;
+			}
+			frames.push_back({file.substr(0, bytes), total,
+							  static_cast<std::size_t>(size)});
+			total += static_cast<std::size_t>(size);
+		}
+		file.remove_prefix(bytes);
+	}
+	return true;
+}
+} // namespace compressed_detail
+
+/**
+ * @brief Decompresses the independent zstd 'frames' (see SplitZstdFrames) a
+ * window of 'window' frames at a time. A window's frames are decoded as one
+ * task each on 'pool' (inline without one), every task with its own context
+ * writing straight into its frame's slice of one buffer. fn(text) then gets
+ * the window's text up to its last newline, and the partial line after it
+ * is carried into the next window. Only one window of text is held at a
+ * time, however large the file.
+ * @return false if a frame is corrupt; fn may have seen earlier windows.
+ */
+template <typename Fn>
+bool DecompressZstdWindows(const std::vector<compressed_detail::ZstdFrame> &frames,
+						   std::size_t window, WorkStealingPool *pool, Fn &&fn)
+{
+	window = window > 0 ? window : 1;
+	std::vector<char> buffer;
+	std::size_t carried = 0; // Bytes of a partial line at the buffer's front
+	for (std::size_t first = 0; first < frames.size(); first += window)
+	{
+		const std::size_t last = std::min(frames.size(), first + window);
+		// Where this window's content starts in the whole output
+		const std::size_t base = frames[first].output;
+		const std::size_t end =
+			carried + frames[last - 1].output + frames[last - 1].size - base;
+		buffer.resize(end);
+		std::vector<char> ok(last - first, 0);
+		{
+			AOC_PROFILE_SCOPE(Decompress);
+			auto decode = [&](std::size_t begin, std::size_t stop)
+			{
+				ZSTD_DCtx *context = ZSTD_createDCtx();
+				for (std::size_t i = begin; context && i < stop; i++)
+				{
+					const compressed_detail::ZstdFrame &frame = frames[first + i];
+					std::size_t got = ZSTD_decompressDCtx(
+						context, buffer.data() + carried + frame.output - base,
+						frame.size, frame.data.data(), frame.data.size());
+					ok[i] = !ZSTD_isError(got) && got == frame.size;
+				}
+				ZSTD_freeDCtx(context);
+			};
+			if (pool)
+			{
+				pool->ParallelFor(
+					last - first, 1,
+					[&](std::size_t begin, std::size_t stop, std::size_t)
+					{ decode(begin, stop); });
+			}
+			else
+			{
+				decode(0, last - first);
+			}
+		}
+		for (char frameOk : ok)
+		{
+			if (!frameOk)
+			{
+				return false;
+			}
+		}
+		std::string_view text(buffer.data(), end);
+		std::size_t newline = text.rfind('\n');
+		std::size_t cut = newline == std::string_view::npos ? 0 : newline + 1;
+		if (cut > 0)
+		{
+			fn(text.substr(0, cut));
+		}
+		std::memmove(buffer.data(), buffer.data() + cut, end - cut);
+		carried = end - cut;
+	}
+	if (carried > 0)
+	{
+		fn(std::string_view(buffer.data(), carried));
+	}
+	return true;
+}
+#endif // AOC_HAVE_ZSTD
+
+/**
+ * @brief Wraps 'upstream' in the decompressor for 'compression'; null if the
+ * codec was not compiled in (or for Compression::None).
+ */
+inline std::unique_ptr<ByteSource> MakeDecompressor(Compression compression,
+													ByteSource &upstream)
+{
+#if AOC_HAVE_ZLIB
+	if (compression == Compression::Gzip)
+	{
+		return std::make_unique<GzipSource>(upstream);
+	}
+#endif
+#if AOC_HAVE_ZSTD
+	if (compression == Compression::Zstd)
+	{
+		return std::make_unique<ZstdSource>(upstream);
+	}
+#endif
+	(void)compression;
+	(void)upstream;
+	return nullptr;
+}
+
+/**
+ * @brief Best guess at the decompressed size of the file at 'path', for
+ * reserving parser output up front; 0 when unknown. gzip records the last
+ * member's size mod 2^32 in its trailer; zstd frames record theirs in the
+ * frame header.
+ */
+inline uint64_t DecompressedSizeHint(const std::string &path,
+									 Compression compression)
+{
+	if (compression == Compression::Gzip)
+	{
+		unsigned char trailer[4];
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		bool ok = file && std::fseek(file, -4, SEEK_END) == 0 &&
+				  std::fread(trailer, 1, 4, file) == 4;
+		if (file)
+		{
+			std::fclose(file);
+		}
+		return ok ? uint64_t(trailer[0]) | uint64_t(trailer[1]) << 8 |
+						uint64_t(trailer[2]) << 16 | uint64_t(trailer[3]) << 24
+				  : 0;
+	}
+#if AOC_HAVE_ZSTD
+	if (compression == Compression::Zstd)
+	{
+		MappedFile file(path);
+		std::vector<compressed_detail::ZstdFrame> frames;
+		std::size_t total = 0;
+		if (file.IsOpen() &&
+			compressed_detail::SplitZstdFrames(file.View(), frames, total))
+		{
+			return total;
+		}
+	}
+#endif
+	return 0;
+}
+
+/**
+ * @brief Calls fn(std::string_view text) with the decompressed text of the
+ * compressed file at 'path', cut at line boundaries (see ForEachLineBlock).
+ * A multi-frame zstd file is decompressed a window of frames at a time on
+ * 'pool' (see DecompressZstdWindows); anything else is streamed in 4 MB
+ * blocks, from a PrefetchReader when 'prefetch' is set, so parsing overlaps
+ * the reads.
+ * Failures are reported on std::cerr.
+ */
+template <typename Fn>
+bool ReadCompressedBlocks(const std::string &path, Compression compression,
+						  bool prefetch, PrefetchBackend backend,
+						  WorkStealingPool *pool, Fn &&fn)
+{
+	constexpr std::size_t kBlockBytes = std::size_t(4) << 20;
+	if (!CompressionSupported(compression))
+	{
+		std::cerr << "ERROR: " << path << " is " << CompressionName(compression)
+				  << "-compressed, but this build has no "
+				  << CompressionName(compression)
+				  << " support (see compressed-input.h)" << std::endl;
+		return false;
+	}
+#if AOC_HAVE_ZSTD
+	if (compression == Compression::Zstd)
+	{
+		MappedFile file(path);
+		std::vector<compressed_detail::ZstdFrame> frames;
+		std::size_t total = 0;
+		if (file.IsOpen() &&
+			compressed_detail::SplitZstdFrames(file.View(), frames, total) &&
+			frames.size() >= 2)
+		{
+			// Two frames per thread keep every thread busy while bounding
+			// the text in memory to one window
+			const std::size_t window = 2 * (pool ? pool->Size() : 1);
+			if (!DecompressZstdWindows(frames, window, pool, fn))
+			{
+				std::cerr << "ERROR: " << path << " has a corrupt zstd frame"
+						  << std::endl;
+				return false;
+			}
+			return true;
+		}
+	}
+#else
+	(void)pool;
+#endif
+
+	PrefetchReader reader;
+	std::FILE *file = nullptr;
+	std::unique_ptr<ByteSource> raw;
+	if (prefetch && reader.Open(path, backend))
+	{
+		raw = std::make_unique<PrefetchSource>(reader);
+	}
+	else if ((file = std::fopen(path.c_str(), "rb")) != nullptr)
+	{
+		raw = std::make_unique<StdioSource>(file);
+	}
+	else
+	{
+		std::cerr << "ERROR: Unable to open file at path: " << path << std::endl;
+		return false;
+	}
+	std::unique_ptr<ByteSource> source = MakeDecompressor(compression, *raw);
+	bool ok = source && ForEachLineBlock(*source, kBlockBytes, fn);
+	if (file)
+	{
+		std::fclose(file);
+	}
+	if (!ok)
+	{
+		std::cerr << "ERROR: " << path << " is not a valid "
+				  << CompressionName(compression) << " stream" << std::endl;
+	}
+	return ok;
+}
+
+/**
+ * @brief Calls fn(std::string_view text) with the text of the input at 'path'
+ * in line-aligned blocks, opening it only once: the compression is sniffed
+ * through a PeekedSource, so a pipe or FIFO (see IsStreamOnly) is read
+ * front to back exactly once, decompressed if need be. Failures are reported
+ * on std::cerr.
+ */
+template <typename Fn>
+bool ReadStreamBlocks(const std::string &path, Fn &&fn)
+{
+	constexpr std::size_t kBlockBytes = std::size_t(4) << 20;
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		std::cerr << "ERROR: Unable to open file at path: " << path << std::endl;
+		return false;
+	}
+	StdioSource stdio(file);
+	PeekedSource peeked(stdio);
+	Compression compression = peeked.Detect();
+	bool ok = false;
+	if (compression == Compression::None)
+	{
+		ok = ForEachLineBlock(peeked, kBlockBytes, fn);
+		if (!ok)
+		{
+			std::cerr << "ERROR: Read failed in " << path << std::endl;
+		}
+	}
+	else if (!CompressionSupported(compression))
+	{
+		std::cerr << "ERROR: " << path << " is " << CompressionName(compression)
+				  << "-compressed, but this build has no "
+				  << CompressionName(compression)
+				  << " support (see compressed-input.h)" << std::endl;
+	}
+	else
+	{
+		std::unique_ptr<ByteSource> source =
+			MakeDecompressor(compression, peeked);
+		ok = source && ForEachLineBlock(*source, kBlockBytes, fn);
+		if (!ok)
+		{
+			std::cerr << "ERROR: " << path << " is not a valid "
+					  << CompressionName(compression) << " stream" << std::endl;
+		}
+	}
+	std::fclose(file);
+	return ok;
+}
+
+#endif // AOC_COMPRESSED_INPUT_H
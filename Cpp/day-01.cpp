@@ -2,94 +2,1091 @@
 #include <charconv>	 // For std::from_chars (fast string-to-int conversion)
 #include <cstdint>	 // For int32_t
 #include <cstdlib>	 // For std::abs (for integers)
-#include <fstream>	 // For std::ifstream (file handling)
+#include <filesystem> // For std::filesystem::file_size (row estimates)
 #include <iostream>	 // For std::cout, std::endl, std::cerr
 #include <map>
-#include <string> // For std::string, getline
-#include <vector> // For std::vector (dynamic arrays)
+#include <memory>	   // For std::unique_ptr
+#include <string>	   // For std::string, getline
+#include <string_view> // For std::string_view (line spans into the mapping)
+#include <vector>	   // For std::vector (dynamic arrays)
 
-// -- Placeholder for IDay.h ---
-// Since we don't need the actual interface, we'll define a simple base class
-// to satisfy the inheritance requirement without needing another file.
-class IDay
+#include "IDay.h"			   // For IDay (shared solver interface)
+#include "column-cache.h"	   // For ColumnCache (binary input cache)
+#include "compressed-input.h" // For ReadCompressedBlocks (gzip / zstd)
+#include "distance-kernel.h"   // For ColumnDistance (SIMD reduction)
+#include "incremental-lists.h" // For IncrementalLists (online updates)
+#include "mapped-file.h" // For MappedFile, NextLine (zero-copy input)
+#include "packed-column.h" // For PackedColumn (compact layout)
+#include "profile.h"	 // For AOC_PROFILE_SCOPE (--profile builds)
+#include "radix-sort.h"	 // For SortColumns (radix / std::sort backends)
+#include "reporter.h"	 // For Reporter (buffered answer output)
+#include "simd-parse.h"	 // For ParseBackend, SelectIntParser
+#include "thread-pool.h" // For WorkStealingPool (parallel parsing)
+#include "value-counter.h" // For ValueCounter (histogram / flat hash counts)
+
+// How PartTwo counts the values of list2.
+enum class CountBackend
+{
+	// Merge when PartOne has already sorted the lists, Histogram otherwise
+	Auto,
+	// Two-pointer merge over the sorted lists: no counting structure at all
+	Merge,
+	// ValueCounter: dense histogram for small ranges, flat hash map otherwise
+	Histogram,
+	// The original std::map, kept as the reference
+	Map,
+};
+
+// Both answers, as returned by Day1::Solve().
+struct Day1Answers
 {
+	int64_t distance = 0;	// Part 1: total distance between the sorted lists
+	int64_t similarity = 0; // Part 2: similarity score
 };
 
+// Tunables for Day1. The defaults use the fastest implementations available
+// on this host.
+struct Day1Options
+{
+	// Which integer parser backend splits each line into its two columns
+	ParseBackend parseBackend = ParseBackend::Auto;
+	// How PartOne sorts the two columns
+	SortBackend sortBackend = SortBackend::Auto;
+	// How PartTwo counts list2
+	CountBackend countBackend = CountBackend::Auto;
+	// Threads used to parse, sort and sum the input: 1 runs inline, 0 uses
+	// one per hardware thread
+	std::size_t threads = 1;
+	// Parse fixed-width columns with the parser unrolled for their width
+	bool fixedShapes = true;
+	// Keep the columns bit-packed at the narrowest width that holds them (17
+	// bits for 5-digit IDs) rather than as int32_t. Parsing is then one slice
+	// at a time on the calling thread; sorting and summing still use the pool
+	bool compact = false;
+	// Smallest span of text parsed as one parallel task, and fewest keys
+	// sorted across the pool (per task, for the compact counting sort). The
+	// self-checks lower both so that their small inputs take the parallel
+	// paths too.
+	std::size_t parallelParseBytes = std::size_t(1) << 20;
+	std::size_t parallelSortKeys = radix_sort_detail::kMinParallelSize;
+	// Input file read when no input was handed to Load()
+	std::string input = "../inputs/input-01.txt";
+	// How the input file is read: through the binary cache, with prefetch
+	LoadOptions load;
+};
+
+// Parses the two-column lines of 'text' into 'left'/'right', skipping lines
+// that hold no integers. Stops at the first line that holds just one and
+// returns false in that case.
+static bool ParseColumns(std::string_view text, IntParser parse,
+						 std::vector<int32_t> &left, std::vector<int32_t> &right)
+{
+	std::string_view line;
+	// Reused for every line, so parsing never allocates after the first one.
+	std::vector<int> columns;
+	while (NextLine(text, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+		columns.clear();
+		parse(line, columns);
+		// A blank line (only spaces or tabs) is skipped like an empty one,
+		// as `myfile >> left >> right` skipped it
+		if (columns.empty())
+		{
+			continue;
+		}
+		if (columns.size() < 2)
+		{
+			return false;
+		}
+		left.push_back(columns[0]);
+		right.push_back(columns[1]);
+	}
+	return true;
+}
+
+// Layout of a Day 1 input whose columns have a fixed width: every line is
+// 'width' digits, 'gap' spaces, 'width' digits and '\n'.
+struct ColumnShape
+{
+	std::size_t width = 0; // 0 when the text has no such shape
+	std::size_t gap = 0;
+};
+
+// Widest column the fixed-width parsers handle (9 digits fit an int32_t).
+constexpr std::size_t kMaxColumnWidth = 9;
+
+// Reads the shape off the first line of 'text'.
+static ColumnShape DetectColumnShape(std::string_view text)
+{
+	auto run = [&](std::size_t from, bool digits)
+	{
+		std::size_t i = from;
+		while (i < text.size() &&
+			   (digits ? text[i] >= '0' && text[i] <= '9' : text[i] == ' '))
+		{
+			i++;
+		}
+		return i - from;
+	};
+	ColumnShape shape;
+	std::size_t width = run(0, true);
+	std::size_t gap = run(width, false);
+	if (width == 0 || width > kMaxColumnWidth || gap == 0 ||
+		run(width + gap, true) != width ||
+		2 * width + gap >= text.size() || text[2 * width + gap] != '\n')
+	{
+		return shape;
+	}
+	shape.width = width;
+	shape.gap = gap;
+	return shape;
+}
+
+// Value of the W digits at 'p'; ORs a flag into 'bad' if any isn't a digit.
+template <std::size_t W>
+static inline uint32_t FixedDigits(const char *p, unsigned &bad)
+{
+	uint32_t value = 0;
+	for (std::size_t k = 0; k < W; k++)
+	{
+		uint32_t digit = static_cast<uint32_t>(static_cast<unsigned char>(p[k])) -
+						 static_cast<uint32_t>('0');
+		bad |= digit > 9;
+		value = value * 10 + digit;
+	}
+	return value;
+}
+
+// Parses the lines at the head of 'text' that match the fixed shape (column
+// width W, 'gap' spaces), removing them from 'text'. Every line sits at a
+// fixed stride and W is a compile-time constant, so each one is two unrolled
+// digit loops and a few byte compares with no search for delimiters.
+template <std::size_t W>
+static void ParseFixedColumns(std::string_view &text, std::size_t gap,
+							  std::vector<int32_t> &left,
+							  std::vector<int32_t> &right)
+{
+	const std::size_t stride = 2 * W + gap + 1;
+	const std::size_t lines = text.size() / stride;
+	const std::size_t base = left.size();
+	left.resize(base + lines);
+	right.resize(base + lines);
+	const char *p = text.data();
+	std::size_t i = 0;
+	for (; i < lines; i++, p += stride)
+	{
+		unsigned bad = p[stride - 1] != '\n';
+		for (std::size_t g = 0; g < gap; g++)
+		{
+			bad |= p[W + g] != ' ';
+		}
+		uint32_t a = FixedDigits<W>(p, bad);
+		uint32_t b = FixedDigits<W>(p + W + gap, bad);
+		if (bad)
+		{
+			break;
+		}
+		left[base + i] = static_cast<int32_t>(a);
+		right[base + i] = static_cast<int32_t>(b);
+	}
+	left.resize(base + i);
+	right.resize(base + i);
+	text.remove_prefix(i * stride);
+}
+
+// ParseColumns with a fixed-width fast path: the shape read off the first
+// line picks the ParseFixedColumns instantiation for that width, and whatever
+// it stops at (a line of another shape, a last line without '\n') goes to
+// the generic parser.
+static bool ParseColumnsShaped(std::string_view text, IntParser parse,
+							   std::vector<int32_t> &left,
+							   std::vector<int32_t> &right)
+{
+	using FixedFn = void (*)(std::string_view &, std::size_t,
+							 std::vector<int32_t> &, std::vector<int32_t> &);
+	static constexpr FixedFn kFixed[kMaxColumnWidth + 1] = {
+		nullptr,
+		&ParseFixedColumns<1>,
+		&ParseFixedColumns<2>,
+		&ParseFixedColumns<3>,
+		&ParseFixedColumns<4>,
+		&ParseFixedColumns<5>,
+		&ParseFixedColumns<6>,
+		&ParseFixedColumns<7>,
+		&ParseFixedColumns<8>,
+		&ParseFixedColumns<9>,
+	};
+	ColumnShape shape = DetectColumnShape(text);
+	if (shape.width != 0)
+	{
+		kFixed[shape.width](text, shape.gap, left, right);
+	}
+	return ParseColumns(text, parse, left, right);
+}
+
+// Similarity score of two sorted lists in one linear merge. Equal values are
+// consumed as runs: a value v appearing ca times on the left and cb times on
+// the right contributes v * ca * cb, exactly what the per-element count
+// lookups add up to.
+static int64_t SimilarityFromSorted(const std::vector<int32_t> &left,
+									const std::vector<int32_t> &right)
+{
+	int64_t total = 0;
+	size_t i = 0, j = 0;
+	while (i < left.size() && j < right.size())
+	{
+		if (left[i] < right[j])
+		{
+			i++;
+		}
+		else if (right[j] < left[i])
+		{
+			j++;
+		}
+		else
+		{
+			int32_t v = left[i];
+			size_t runLeft = 0, runRight = 0;
+			for (; i < left.size() && left[i] == v; i++)
+			{
+				runLeft++;
+			}
+			for (; j < right.size() && right[j] == v; j++)
+			{
+				runRight++;
+			}
+			total += int64_t(v) * int64_t(runLeft) * int64_t(runRight);
+		}
+	}
+	return total;
+}
+
 // -- CLASS DEFINITION --
-// Defines the main logic class, inheriting from the simple placeholder IDay.
+// Defines the main logic class, implementing the shared IDay interface.
 class Day1 : public IDay
 {
 private:
+	Day1Options options;
+
 	// Public members to store the data from the two columns. std::vector is the
 	// C++ standard library's dynamic array
 	std::vector<int32_t> list1;
 	std::vector<int32_t> list2;
 
-	// private function to handle all file I/O.
+	// The columns in the compact layout (Day1Options::compact). list1/list2
+	// are then only the parse buffers of one slice.
+	PackedColumn packed1;
+	PackedColumn packed2;
+
+	// Bytes of text the current load will parse (0 if unknown), from which
+	// the first Append reserves the columns.
+	std::size_t expectedBytes = 0;
+
+	// Pool for parallel parsing and sorting (null when running inline)
+	std::unique_ptr<WorkStealingPool> pool;
+
+	// Set once both lists have been sorted in place.
+	bool sorted = false;
+	// Set once a load has filled the lists completely; cleared while one is
+	// in progress and when one fails.
+	bool loaded = false;
+
+	// private function to handle all file I/O; parses through Load().
 	bool ReadFileData();
 
+	// Empties the lists for a new input, and parses 'input' onto their ends.
+	// Append returns false if it stopped at a malformed line.
+	void Clear();
+	bool Append(std::string_view input);
+
+	// Reserves the columns for 'rows' rows in total.
+	void ReserveRows(std::size_t rows);
+	// Heap bytes held by the columns, for the profile's column_bytes.
+	std::size_t ColumnBytes() const;
+
+	// Shared steps of PartOne, PartTwo and Solve.
+	void SortLists();
+	int64_t TotalDistance() const;
+	int64_t SimilarityScore();
+
 public:
+	explicit Day1(const Day1Options &options = Day1Options())
+		: options(options)
+	{
+		if (options.threads != 1)
+		{
+			pool = std::make_unique<WorkStealingPool>(options.threads);
+		}
+	}
+
 	// Declarations for the logic functions. The definitions follow below.
-	void PartOne();
-	void PartTwo();
+	bool Load(std::string_view input) override;
+	bool LoadFile(const std::string &path, const LoadOptions &load) override;
+	int64_t PartOne() override;
+	int64_t PartTwo() override;
+
+	// Reads the input, sorts it once and computes both parts without
+	// printing. Returns false if the input could not be read.
+	bool Solve(Day1Answers &answers);
+	bool Solve(int64_t &part1, int64_t &part2) override;
+
+	// Sharded runs: Map sorts the lists and returns their distinct values
+	// with the count in each list; Combine merges those runs into the exact
+	// answers of all shards together.
+	PartialResult Map() override;
+	void Combine(const std::vector<PartialResult> &partials, int64_t &part1,
+				 int64_t &part2) override;
+
+	// Checks every parser, sort, count backend, layout and the shard merge
+	// against the scalar parser, std::sort and std::map counting.
+	bool SelfCheck(std::string_view input, std::ostream &log) override;
+
+	// Loads the input, then applies the pair updates in 'path' and reports
+	// both answers after every batch. Returns false if a file can't be read.
+	bool ApplyUpdates(const std::string &path, Reporter &reporter);
 };
 
 bool Day1::ReadFileData()
 {
-	// Open the file. RAII: Destructor will automatically call myfile.close()
-	// when scope ends.
-	std::ifstream myfile("../inputs/input-01.txt.txt");
+	return LoadFile(options.input, options.load);
+}
+
+bool Day1::LoadFile(const std::string &path, const LoadOptions &load)
+{
+	loaded = false;
+	// The cache is only trusted while it matches the text's size and mtime
+	CacheSource source;
+	bool cacheable = load.cache && StatCacheSource(path, source);
+	const std::string cachePath = ColumnCachePath(path);
+	ColumnCache cache;
+	if (cacheable && cache.Open(cachePath, CacheKind::Day1Columns, source) &&
+		cache.Columns() == 2)
+	{
+		AOC_PROFILE_SCOPE(Read);
+		cache.Decode(0, list1);
+		cache.Decode(1, list2);
+		sorted = cache.Sorted();
+		if (options.compact)
+		{
+			packed1.Clear();
+			packed2.Clear();
+			packed1.Append(list1.data(), list1.size());
+			packed2.Append(list2.data(), list2.size());
+			std::vector<int32_t>().swap(list1);
+			std::vector<int32_t>().swap(list2);
+		}
+		AOC_PROFILE_COUNT(ColumnBytes, ColumnBytes());
+		loaded = options.compact ? packed1.Size() == packed2.Size()
+								 : list1.size() == list2.size();
+		return loaded;
+	}
 
-	if (!myfile.is_open())
+	// Text size, for reserving the columns up front: without it they grow by
+	// doubling, copying each time and ending up to twice the size needed.
+	Compression compression = FileCompression(path);
+	std::error_code error;
+	std::size_t textBytes =
+		compression != Compression::None
+			? static_cast<std::size_t>(DecompressedSizeHint(path, compression))
+			: static_cast<std::size_t>(std::filesystem::file_size(path, error));
+	if (error)
+	{
+		textBytes = 0;
+	}
+	// Cleared by the first line that doesn't hold two integers: the columns
+	// keep the lines before it, and the load fails
+	bool complete = true;
+	if (IsStreamOnly(path))
 	{
-		std::cerr << "Error: Could not open file." << std::endl;
+		// A pipe or FIFO can only be read once: sniff and parse in one pass
+		Clear();
+		if (!ReadStreamBlocks(path, [&](std::string_view text)
+							  { complete = complete && Append(text); }))
+		{
+			return false;
+		}
+	}
+	else if (compression != Compression::None)
+	{
+		// Decompressed blocks go straight to the parser
+		Clear();
+		expectedBytes = textBytes;
+		if (!ReadCompressedBlocks(path, compression, load.prefetch,
+								  load.prefetchBackend, pool.get(),
+								  [&](std::string_view text)
+								  { complete = complete && Append(text); }))
+		{
+			return false;
+		}
+	}
+	else if (load.prefetch)
+	{
+		// Parse each block as soon as it arrives, while the reads after it
+		// are still in flight.
+		Clear();
+		expectedBytes = textBytes;
+		if (!ReadLineBlocks(path, load.prefetchBackend,
+							[&](std::string_view text)
+							{ complete = complete && Append(text); }))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Map the whole file. RAII: the destructor unmaps it when scope ends,
+		// and every line below is a std::string_view straight into the
+		// mapping, so no text is copied.
+		MappedFile myfile(path);
+
+		if (!myfile.IsOpen())
+		{
+			std::cerr << "Error: Could not open file: " << path << std::endl;
+			return false;
+		}
+		complete = Load(myfile.View());
+	}
+	if (!complete)
+	{
+		std::cerr << "Error: Malformed line in file: " << path << std::endl;
 		return false;
 	}
+	AOC_PROFILE_COUNT(ColumnBytes, ColumnBytes());
+	// The cache writer encodes int32_t columns, which the compact layout
+	// doesn't keep; it still reads caches written by a normal run.
+	if (cacheable && !options.compact)
+	{
+		// Cache the columns sorted: PartOne sorts them anyway, sorted columns
+		// delta-pack to a few bits per value, and a cached load then skips
+		// the sort as well as the parse.
+		SortLists();
+		ColumnCacheWriter writer;
+		writer.AddColumn(list1.data(), list1.size());
+		writer.AddColumn(list2.data(), list2.size());
+		writer.Write(cachePath, CacheKind::Day1Columns, kCacheSorted, source);
+	}
+	loaded = true;
+	return true;
+}
+
+bool Day1::Load(std::string_view input)
+{
+	Clear();
+	expectedBytes = input.size();
+	loaded = Append(input);
+	return loaded;
+}
 
-	int32_t left, right;
+void Day1::Clear()
+{
+	list1.clear();
+	list2.clear();
+	packed1.Clear();
+	packed2.Clear();
+	expectedBytes = 0;
+	sorted = false;
+	loaded = false;
+}
 
-	// **IDIOMATIC C++ INPUT:** The `>>` operator reads formatted input.
-	// It automatically skips all intermediate whitespace (spaces, tabs,
-	// newlines) and attempts to convert the next non-whitespace sequence into
-	// the target type (int32_t). The loop continues as long as two successful
-	// reads occur.
-	while (myfile >> left >> right)
+void Day1::ReserveRows(std::size_t rows)
+{
+	if (options.compact)
 	{
-		list1.push_back(left);
-		list2.push_back(right);
+		packed1.Reserve(rows);
+		packed2.Reserve(rows);
+	}
+	else
+	{
+		list1.reserve(rows);
+		list2.reserve(rows);
+	}
+}
+
+std::size_t Day1::ColumnBytes() const
+{
+	return options.compact
+			   ? packed1.Bytes() + packed2.Bytes()
+			   : (list1.capacity() + list2.capacity()) * sizeof(int32_t);
+}
+
+bool Day1::Append(std::string_view input)
+{
+	AOC_PROFILE_SCOPE(Parse);
+	IntParser parse = SelectIntParser(options.parseBackend);
+	auto parseColumns = options.fixedShapes ? ParseColumnsShaped : ParseColumns;
+	if (expectedBytes > 0)
+	{
+		ReserveRows(EstimateLineCount(input, expectedBytes));
+		expectedBytes = 0;
+	}
+
+	if (options.compact)
+	{
+		// Parse about 1 MB of lines at a time into list1/list2 and pack each
+		// slice, so the int32_t columns never hold more than one slice.
+		constexpr std::size_t kSliceBytes = std::size_t(1) << 20;
+		bool complete = true;
+		for (std::string_view slice :
+			 SplitAtLineBoundaries(input, input.size() / kSliceBytes + 1,
+								   kSliceBytes))
+		{
+			list1.clear();
+			list2.clear();
+			complete = parseColumns(slice, parse, list1, list2);
+			packed1.Append(list1.data(), list1.size());
+			packed2.Append(list2.data(), list2.size());
+			if (!complete)
+			{
+				break;
+			}
+		}
+		list1.clear();
+		list2.clear();
+		return complete;
+	}
+
+	std::vector<std::string_view> spans;
+	if (pool)
+	{
+		spans = SplitAtLineBoundaries(input, pool->Size() * 4,
+									  options.parallelParseBytes);
+	}
+
+	// Walk the text one line span at a time. Same contract as the old
+	// `myfile >> left >> right` loop: stop at the first line that doesn't
+	// hold two integers.
+	if (spans.size() <= 1)
+	{
+		return parseColumns(input, parse, list1, list2);
+	}
+
+	// Parallel: each span (cut at a newline) is parsed into its own columns,
+	// then the pieces are concatenated in file order, up to and including
+	// the first span that hit a malformed line.
+	struct Piece
+	{
+		std::vector<int32_t> left, right;
+		bool complete = true;
+	};
+	std::vector<Piece> pieces(spans.size());
+	pool->ParallelFor(spans.size(), 1,
+					  [&](std::size_t begin, std::size_t end, std::size_t)
+					  {
+						  for (std::size_t i = begin; i < end; i++)
+						  {
+							  pieces[i].complete =
+								  parseColumns(spans[i], parse, pieces[i].left,
+											   pieces[i].right);
+						  }
+					  });
+	std::size_t rows = 0;
+	for (const Piece &piece : pieces)
+	{
+		rows += piece.left.size();
+	}
+	// Exact for a single Load; later blocks leave growth to insert(), which
+	// doubles instead of reallocating every block.
+	if (list1.empty())
+	{
+		list1.reserve(rows);
+		list2.reserve(rows);
+	}
+	for (const Piece &piece : pieces)
+	{
+		list1.insert(list1.end(), piece.left.begin(), piece.left.end());
+		list2.insert(list2.end(), piece.right.begin(), piece.right.end());
+		if (!piece.complete)
+		{
+			return false;
+		}
 	}
 	return true;
 }
 
 // --- METHOD IMPLEMENTATION: Day1::PartOne ---
 
-void Day1::PartOne()
+int64_t Day1::PartOne()
 {
 	// --- File Reading and Data Parsing ---
 
-	if (!ReadFileData())
+	if (!loaded && !ReadFileData())
+	{
+		return 0; // Stop if file reading failed
+	}
+
+	SortLists();
+	return TotalDistance();
+}
+
+int64_t Day1::PartTwo()
+{
+	if (!loaded && !ReadFileData())
 	{
-		return; // Stop if file reading failed
+		return 0;
 	}
+	return SimilarityScore();
+}
 
-	// Sort the collected lists
-	std::sort(list1.begin(), list1.end());
-	std::sort(list2.begin(), list2.end());
+bool Day1::Solve(Day1Answers &answers)
+{
+	if (!loaded && !ReadFileData())
+	{
+		return false;
+	}
+	// One sort serves both parts: the distance pairs the sorted lists and
+	// the similarity score merges them.
+	SortLists();
+	answers.distance = TotalDistance();
+	AOC_PROFILE_SCOPE(Count);
+	answers.similarity = options.compact
+							 ? PackedSimilaritySorted(packed1, packed2)
+							 : SimilarityFromSorted(list1, list2);
+	return true;
+}
 
-	// Calculate Part One: total distance between lists
-	long sum = 0;
-	// Iterate and pair the sorted elements from both lists.
-	for (size_t i = 0; i < list1.size(); i++)
-		// Cast to 'long' before subtraction to avoid potential overflow during
-		// calculation. std::abs from <cstdlib> is used for integer absolute
-		// value.
-		sum += std::abs((long)list1[i] - (long)list2[i]);
+bool Day1::Solve(int64_t &part1, int64_t &part2)
+{
+	Day1Answers answers;
+	if (!Solve(answers))
+	{
+		return false;
+	}
+	part1 = answers.distance;
+	part2 = answers.similarity;
+	return true;
+}
 
-	std::cout << "Part 1: " << sum << std::endl;
+PartialResult Day1::Map()
+{
+	PartialResult partial;
+	if (!loaded && !ReadFileData())
+	{
+		partial.ok = false;
+		return partial;
+	}
+	SortLists();
+	if (options.compact)
+	{
+		AppendValueRuns(
+			packed1.Size(), [&](std::size_t i) { return packed1.Get(i); },
+			packed2.Size(), [&](std::size_t j) { return packed2.Get(j); },
+			partial.runs);
+	}
+	else
+	{
+		AppendValueRuns(
+			list1.size(), [&](std::size_t i) { return list1[i]; }, list2.size(),
+			[&](std::size_t j) { return list2[j]; }, partial.runs);
+	}
+	return partial;
 }
 
-void Day1::PartTwo()
+// The merged runs are the histogram of both whole lists. Similarity is
+// sum(v * left(v) * right(v)); the distance between the sorted lists is the
+// integral of |#{left <= t} - #{right <= t}| over t (as in
+// IncrementalLists), which is constant between consecutive distinct values.
+void Day1::Combine(const std::vector<PartialResult> &partials, int64_t &part1,
+				   int64_t &part2)
 {
+	int64_t distance = 0, similarity = 0, balance = 0;
+	int32_t previous = 0;
+	bool first = true;
+	MergeValueRuns(partials,
+				   [&](int32_t value, uint64_t left, uint64_t right)
+				   {
+					   if (!first)
+					   {
+						   int64_t gap = int64_t(value) - int64_t(previous);
+						   distance += (balance < 0 ? -balance : balance) * gap;
+					   }
+					   balance += int64_t(left) - int64_t(right);
+					   similarity +=
+						   int64_t(value) * int64_t(left) * int64_t(right);
+					   previous = value;
+					   first = false;
+				   });
+	part1 = distance;
+	part2 = similarity;
+}
+
+bool Day1::SelfCheck(std::string_view input, std::ostream &log)
+{
+	bool ok = true;
+	auto check = [&](const std::string &what, bool agrees)
+	{
+		if (!agrees)
+		{
+			log << "day1: " << what << " disagrees with the reference"
+				<< std::endl;
+			ok = false;
+		}
+	};
+
+	// The reference: scalar parser, std::sort, a plain distance loop and the
+	// original std::map counts
+	std::vector<int32_t> left, right;
+	const bool complete = ParseColumns(input, ParseIntsScalar, left, right);
+	std::vector<int32_t> sortedLeft = left, sortedRight = right;
+	std::sort(sortedLeft.begin(), sortedLeft.end());
+	std::sort(sortedRight.begin(), sortedRight.end());
+	int64_t distance = 0, similarity = 0;
+	for (std::size_t i = 0; i < sortedLeft.size(); i++)
+	{
+		distance += std::llabs(int64_t(sortedLeft[i]) - int64_t(sortedRight[i]));
+	}
+	std::map<int32_t, int64_t> counts2;
+	for (int32_t n : right)
+	{
+		counts2[n]++;
+	}
+	for (int32_t i : left)
+	{
+		similarity += int64_t(i) * counts2[i];
+	}
+
+	// Every parser, with and without the fixed-width path, stops at the same
+	// line with the same columns
+	for (ParseBackend backend : kParseBackends)
+	{
+		if (!ParseBackendSupported(backend))
+		{
+			continue;
+		}
+		for (bool shaped : {false, true})
+		{
+			std::vector<int32_t> l, r;
+			bool c = (shaped ? ParseColumnsShaped : ParseColumns)(
+				input, SelectIntParser(backend), l, r);
+			check(std::string("parser ") + ParseBackendName(backend) +
+					  (shaped ? " (fixed-width)" : ""),
+				  c == complete && l == left && r == right);
+		}
+	}
+
+	// Every configuration gives the reference answers. PartTwo first counts
+	// the unsorted lists, so the histogram and map backends are reached.
+	struct Variant
+	{
+		const char *name;
+		Day1Options options;
+		bool partTwoFirst;
+	};
+	std::vector<Variant> variants;
+	auto add = [&](const char *name, bool partTwoFirst, auto &&tweak)
+	{
+		Variant variant{name, Day1Options(), partTwoFirst};
+		tweak(variant.options);
+		variants.push_back(variant);
+	};
+	add("defaults", false, [](Day1Options &) {});
+	add("std sort", false, [](Day1Options &o) { o.sortBackend = SortBackend::Std; });
+	add("radix sort", false,
+		[](Day1Options &o) { o.sortBackend = SortBackend::Radix; });
+	add("merge count", true,
+		[](Day1Options &o) { o.countBackend = CountBackend::Merge; });
+	add("histogram count", true,
+		[](Day1Options &o) { o.countBackend = CountBackend::Histogram; });
+	add("map count", true, [](Day1Options &o) { o.countBackend = CountBackend::Map; });
+	add("no fixed shapes", false, [](Day1Options &o) { o.fixedShapes = false; });
+	add("compact", false, [](Day1Options &o) { o.compact = true; });
+	add("compact, part two first", true, [](Day1Options &o) { o.compact = true; });
+	// Threaded variants drop the parallel thresholds, so that even a few
+	// lines are parsed in several spans and radix-sorted across the pool
+	auto threaded = [](Day1Options &o)
+	{
+		o.threads = 3;
+		o.parallelParseBytes = 16;
+		o.parallelSortKeys = 0;
+	};
+	add("3 threads", false, threaded);
+	add("3 threads, radix sort", false,
+		[&](Day1Options &o)
+		{
+			threaded(o);
+			o.sortBackend = SortBackend::Radix;
+		});
+	add("3 threads, compact", true,
+		[&](Day1Options &o)
+		{
+			threaded(o);
+			o.compact = true;
+		});
+	// A malformed line fails the load and leaves nothing to solve, so the
+	// solvers then run on the lines before it, one pair per line
+	std::string prefix;
+	if (!complete)
+	{
+		for (std::size_t i = 0; i < left.size(); i++)
+		{
+			prefix += std::to_string(left[i]) + "   " +
+					  std::to_string(right[i]) + "\n";
+		}
+	}
+	const std::string_view solved = complete ? input : prefix;
+	for (const Variant &variant : variants)
+	{
+		Day1 failed(variant.options);
+		check(std::string(variant.name) + ", load result",
+			  failed.Load(input) == complete);
+
+		Day1 solver(variant.options);
+		solver.Load(solved);
+		int64_t part1 = 0, part2 = 0;
+		if (variant.partTwoFirst)
+		{
+			part2 = solver.PartTwo();
+			part1 = solver.PartOne();
+		}
+		else
+		{
+			part1 = solver.PartOne();
+			part2 = solver.PartTwo();
+		}
+		check(variant.name, part1 == distance && part2 == similarity);
+
+		// Solve gives both answers from its one sort
+		Day1 both(variant.options);
+		both.Load(solved);
+		Day1Answers answers;
+		check(std::string(variant.name) + ", Solve",
+			  both.Solve(answers) && answers.distance == distance &&
+				  answers.similarity == similarity);
+	}
+
+	// Blank lines are skipped and a one-integer line fails the load, with
+	// and without the fixed-width path (checked apart from ParseColumns,
+	// which the reference above shares)
+	for (bool shapes : {false, true})
+	{
+		Day1Options o;
+		o.fixedShapes = shapes;
+		Day1 blank(o), oneColumn(o);
+		check(std::string("blank lines") + (shapes ? " (fixed-width)" : ""),
+			  blank.Load("3   4\n  \n\t\n\n4   3\n") && blank.PartOne() == 0 &&
+				  blank.PartTwo() == 7);
+		check(std::string("one-integer line") + (shapes ? " (fixed-width)" : ""),
+			  !oneColumn.Load("3   4\n5\n4   3\n"));
+	}
+
+	// The compact counting sort only splits its rewrite across the pool
+	// when the key range is small next to the column, which random IDs
+	// never are: 2-bit keys drawn from the input reach it, with every
+	// 64-value block its own task and enough blocks that the workers overlap
+	{
+		const std::size_t rows = std::size_t(1) << 14;
+		std::string narrow;
+		narrow.reserve(rows * 6);
+		int64_t leftCounts[4] = {}, rightCounts[4] = {};
+		for (std::size_t i = 0; i < rows; i++)
+		{
+			uint32_t a = left.empty() ? 0 : uint32_t(left[i % left.size()]);
+			uint32_t b = right.empty() ? 0 : uint32_t(right[i % right.size()]);
+			uint32_t l = (a + uint32_t(i)) & 3, r = (b + uint32_t(i / 3)) & 3;
+			leftCounts[l]++;
+			rightCounts[r]++;
+			narrow += char('0' + l);
+			narrow += "   ";
+			narrow += char('0' + r);
+			narrow += '\n';
+		}
+		// Sorted, both lists are runs of 0..3: the distance counts the
+		// positions where the runs disagree
+		int64_t narrowDistance = 0, narrowSimilarity = 0, balance = 0;
+		for (int32_t v = 0; v < 4; v++)
+		{
+			narrowSimilarity += v * leftCounts[v] * rightCounts[v];
+			if (v > 0)
+			{
+				narrowDistance += balance < 0 ? -balance : balance;
+			}
+			balance += leftCounts[v] - rightCounts[v];
+		}
+		Day1Options o;
+		threaded(o);
+		o.compact = true;
+		o.parallelSortKeys = 64;
+		Day1 solver(o);
+		solver.Load(narrow);
+		Day1Answers answers;
+		check("3 threads, compact, 2-bit keys",
+			  solver.Solve(answers) && answers.distance == narrowDistance &&
+				  answers.similarity == narrowSimilarity);
+	}
+
+	// Two shards cut at a line map and combine to the same answers (only
+	// when every line parses: a malformed line ends the input, not a shard)
+	if (complete)
+	{
+		std::size_t cut = input.find('\n', input.size() / 2);
+		cut = cut == std::string_view::npos ? input.size() : cut + 1;
+		Day1 head, tail;
+		head.Load(input.substr(0, cut));
+		tail.Load(input.substr(cut));
+		int64_t part1 = 0, part2 = 0;
+		Combine({head.Map(), tail.Map()}, part1, part2);
+		check("map/combine", part1 == distance && part2 == similarity);
+	}
+	return ok;
+}
+
+// Update files hold one change per line: "+ left right" adds a pair and
+// "- left right" removes one. A blank line ends a batch; the answers are
+// reported after each batch, updated in place rather than recomputed.
+bool Day1::ApplyUpdates(const std::string &path, Reporter &reporter)
+{
+	if (!loaded && !ReadFileData())
+	{
+		return false;
+	}
+	MappedFile updates(path);
+	if (!updates.IsOpen())
+	{
+		std::cerr << "Error: Could not open update file " << path << std::endl;
+		return false;
+	}
+
+	// The update structure needs plain columns
+	if (options.compact)
+	{
+		list1.resize(packed1.Size());
+		list2.resize(packed2.Size());
+		packed1.Unpack(0, list1.size(), list1.data());
+		packed2.Unpack(0, list2.size(), list2.data());
+	}
+	IncrementalLists lists(list1, list2);
+	IntParser parse = SelectIntParser(options.parseBackend);
+	std::vector<int> columns;
+	std::size_t batch = 0, pending = 0;
+	auto report = [&]()
+	{
+		reporter.Line("Batch " + std::to_string(++batch) + " (" +
+					  std::to_string(lists.Size()) + " pairs)");
+		reporter.Part(1, lists.Distance());
+		reporter.Part(2, lists.Similarity());
+		pending = 0;
+	};
+
+	std::string_view rest = updates.View(), line;
+	while (NextLine(rest, line))
+	{
+		if (line.empty())
+		{
+			if (pending > 0)
+			{
+				report();
+			}
+			continue;
+		}
+		char op = line[0];
+		columns.clear();
+		parse(line.substr(1), columns);
+		if ((op != '+' && op != '-') || columns.size() < 2)
+		{
+			std::cerr << "Error: Bad update line: " << line << std::endl;
+			return false;
+		}
+		if (op == '+')
+		{
+			lists.Insert(columns[0], columns[1]);
+		}
+		else if (!lists.Remove(columns[0], columns[1]))
+		{
+			std::cerr << "Warning: Pair not present: " << line << std::endl;
+		}
+		pending++;
+	}
+	if (pending > 0)
+	{
+		report();
+	}
+	return true;
+}
+
+void Day1::SortLists()
+{
+	// Already sorted by an earlier part (or loaded sorted from the cache)
+	if (sorted)
+	{
+		return;
+	}
+	AOC_PROFILE_SCOPE(Sort);
+	if (options.compact)
+	{
+		// Counting sort over the packed keys, rewritten in place
+		SortPackedColumn(packed1, pool.get(), options.parallelSortKeys);
+		SortPackedColumn(packed2, pool.get(), options.parallelSortKeys);
+		sorted = true;
+		return;
+	}
+	// Sort the collected lists together (LSD radix sort for large columns):
+	// with a pool, both columns' passes run in the same parallel steps
+	std::vector<int32_t> *columns[] = {&list1, &list2};
+	SortColumns(columns, 2, options.sortBackend, pool.get(),
+				options.parallelSortKeys);
+	sorted = true;
+}
+
+int64_t Day1::TotalDistance() const
+{
+	AOC_PROFILE_SCOPE(Distance);
+	// Calculate Part One: total distance between lists, pairing the sorted
+	// elements in a vectorised reduction (split across the pool if there is
+	// one) with 64-bit accumulators
+	if (options.compact)
+	{
+		return PackedDistance(packed1, packed2, pool.get());
+	}
+	return ColumnDistance(list1.data(), list2.data(), list1.size(), pool.get());
+}
+
+int64_t Day1::SimilarityScore()
+{
+	AOC_PROFILE_SCOPE(Count);
+	CountBackend backend = options.countBackend;
+	if (backend == CountBackend::Auto)
+	{
+		backend = sorted ? CountBackend::Merge : CountBackend::Histogram;
+	}
+
+	int64_t total = 0;
+	if (options.compact)
+	{
+		// A histogram of list2's packed keys, or the merge once sorted
+		int64_t counted = 0;
+		if (backend != CountBackend::Merge && !sorted &&
+			PackedSimilarityCounted(packed1, packed2, counted))
+		{
+			return counted;
+		}
+		SortLists();
+		return PackedSimilaritySorted(packed1, packed2);
+	}
+	if (backend == CountBackend::Merge)
+	{
+		// Reuse PartOne's sort: a single two-pointer pass, no allocation.
+		if (!sorted)
+		{
+			SortLists();
+		}
+		return SimilarityFromSorted(list1, list2);
+	}
+	if (backend == CountBackend::Histogram)
+	{
+		// Count list2 into a dense histogram (or a flat hash map for wide
+		// value ranges): a linear build and one lookup per element, with no
+		// node allocations and no zero entries inserted on misses.
+		ValueCounter counts2(list2);
+		for (int32_t i : list1)
+		{
+			total += int64_t(i) * counts2.Count(i);
+		}
+		return total;
+	}
+
 	// OPTIMIZATION: Create a map to pre-count elements in list2 for faster
 	// lookups. This makes the second loop much faster than repeatedly calling
 	// std::count().
@@ -99,27 +1096,152 @@ void Day1::PartTwo()
 		counts2[n]++;
 	}
 
-	long total = 0;
 	// Calculate Part Two: similarity score
 	for (int32_t i : list1)
 	{
 		// Multiply the element 'i' by its count found in the pre-calculated map
 		// (counts2[i]). If i is not in the map, counts2[i] returns 0.
-		total += (long)i * counts2[i];
+		total += int64_t(i) * counts2[i];
 	}
+	return total;
+}
 
-	std::cout << "Part 2: " << total << std::endl;
+// Factory used by the multi-day runner (runner.cpp).
+std::unique_ptr<IDay> MakeDay1()
+{
+	return std::make_unique<Day1>();
 }
 
 // --- MAIN ENTRY POINT ---
+// Left out when this file is linked into the runner, which has its own main.
+#ifndef AOC_RUNNER
+AOC_PROFILE_ALLOCATION_HOOK()
 
-int main()
+int main(int argc, char **argv)
 {
+	Day1Options options;
+	// Pair updates to apply after loading the input (empty: just solve)
+	std::string updatesPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		std::string_view value = i + 1 < argc ? argv[i + 1] : "";
+		// --parser <auto|scalar|sse4.2|avx2|neon> selects the parse backend
+		if (arg == "--parser" &&
+			ParseBackendFromName(value, options.parseBackend))
+		{
+			i++;
+		}
+		// --sort <auto|std|radix> selects the column sort
+		else if (arg == "--sort" &&
+				 SortBackendFromName(value, options.sortBackend))
+		{
+			i++;
+		}
+		// --count <auto|merge|histogram|map> selects how PartTwo counts list2
+		else if (arg == "--count" &&
+				 (value == "auto" || value == "merge" ||
+				  value == "histogram" || value == "map"))
+		{
+			options.countBackend = value == "merge"		  ? CountBackend::Merge
+								   : value == "histogram" ? CountBackend::Histogram
+								   : value == "map"		  ? CountBackend::Map
+														  : CountBackend::Auto;
+			i++;
+		}
+		// --shapes <on|off> toggles the fixed-width column parser
+		else if (arg == "--shapes" && (value == "on" || value == "off"))
+		{
+			options.fixedShapes = value == "on";
+			i++;
+		}
+		// --compact stores the columns bit-packed (about half the memory)
+		else if (arg == "--compact")
+		{
+			options.compact = true;
+		}
+		// --threads <n> parses, sorts and sums on n threads (0 = all cores)
+		else if (arg == "--threads" && !value.empty() &&
+				 std::from_chars(value.data(), value.data() + value.size(),
+								 options.threads)
+						 .ec == std::errc())
+		{
+			i++;
+		}
+		// --input <path> reads another input file (plain, gzip or zstd)
+		else if (arg == "--input" && !value.empty())
+		{
+			options.input = value;
+			i++;
+		}
+		// --updates <path> applies batches of pair inserts/removals
+		else if (arg == "--updates" && !value.empty())
+		{
+			updatesPath = value;
+			i++;
+		}
+		// --cache reuses the parsed input saved next to the input file
+		else if (arg == "--cache")
+		{
+			options.load.cache = true;
+		}
+		// --prefetch <auto|io_uring|thread> reads with asynchronous prefetch
+		else if (arg == "--prefetch" &&
+				 PrefetchBackendFromName(value, options.load.prefetchBackend))
+		{
+			options.load.prefetch = true;
+			i++;
+		}
+		// --profile prints phase timings and counters as JSON to stderr
+		else if (arg == "--profile")
+		{
+#ifdef AOC_PROFILE
+			profile::Enable();
+#else
+			std::cerr << "--profile needs a build with -DAOC_PROFILE" << std::endl;
+			return 1;
+#endif
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0]
+					  << " [--parser auto|scalar|sse4.2|avx2|neon]"
+						 " [--sort auto|std|radix]"
+						 " [--count auto|merge|histogram|map] [--shapes on|off]"
+						 " [--compact] [--threads n] [--input path] [--updates path]"
+						 " [--cache] [--prefetch auto|io_uring|thread]"
+						 " [--profile]"
+					  << std::endl;
+			return 1;
+		}
+	}
+
+	AOC_PROFILE_REPORT("day1");
+
 	// Create an instance of the solver class.
-	Day1 solver;
+	Day1 solver(options);
+	Reporter reporter;
+
+	// A missing input, or a line without two integers, is an error rather
+	// than an answer computed from the lines before it
+	if (!solver.LoadFile(options.input, options.load))
+	{
+		return 1;
+	}
+	if (!updatesPath.empty())
+	{
+		return solver.ApplyUpdates(updatesPath, reporter) ? 0 : 1;
+	}
 
-	solver.PartOne();
-	solver.PartTwo();
+	// Both parts from one sort
+	Day1Answers answers;
+	if (!solver.Solve(answers))
+	{
+		return 1;
+	}
+	reporter.Part(1, answers.distance);
+	reporter.Part(2, answers.similarity);
 
 	return 0;
-};
+}
+#endif // AOC_RUNNER
@@ -2,10 +2,35 @@
 #include <cctype>	 // Required for std::isspace
 #include <charconv>	 // Required for std::from_chars (efficient string to integer conversion)
 #include <cmath>	 // Required for std::abs (specifically for integer types)
-#include <fstream>	 // Required for std::ifstream (file input)
+#include <cstdint>	 // Required for int64_t (part answers)
+#include <cstdio>	 // Required for std::FILE, std::fopen (streaming input)
+#include <iomanip>	 // Required for std::quoted (self-check logs)
 #include <iostream>	 // Required for std::cout and std::endl (console I/O)
-#include <string>	 // Required for std::string
-#include <vector>	 // Required for std::vector
+#include <memory>	 // Required for std::unique_ptr
+#include <memory_resource> // Required for std::pmr::vector (arena buffers)
+#include <string>	   // Required for std::string
+#include <string_view> // Required for std::string_view (line spans)
+#include <vector>	   // Required for std::vector
+
+#include "IDay.h"		  // Required for IDay (shared solver interface)
+#include "arena.h"		  // Required for ScratchArena
+#include "column-cache.h" // Required for ColumnCache (binary input cache)
+#include "compressed-input.h" // Required for PeekedSource, MakeDecompressor
+#include "line-stream.h"  // Required for LineStream, StdioSource
+#include "mapped-file.h"  // Required for MappedFile, ForEachLine
+#include "profile.h"	  // Required for AOC_PROFILE_SCOPE (--profile builds)
+#include "report-batch.h" // Required for ClassifyBatched, SafeMask
+#include "reporter.h"	  // Required for Reporter (buffered answer output)
+#include "report-table.h" // Required for ReportTable (flat CSR storage)
+#include "safety-kernel.h" // Required for IsSafeReport, IsSafeShaped
+#include "simd-parse.h"	  // Required for ParseBackend, SelectIntParser
+#include "thread-pool.h"  // Required for WorkStealingPool
+
+#if __has_include(<unistd.h>)
+#define AOC_HAVE_FMEMOPEN 1 // POSIX fmemopen, for self-checking --stream
+#else
+#define AOC_HAVE_FMEMOPEN 0
+#endif
 
 // --- Utility Functions Implementation ---
 
@@ -60,58 +85,168 @@ std::vector<int> DelimitedToInts(const std::string &s)
 }
 
 /**
- * @brief Reads a file line by line and converts each line into a vector of
- * integers using DelimitedToInts.
- * @param path The file path
- * @return std::vector<std::vector<int>> A vector where each inner vector is a
- * line from the file.
+ * @brief Appending variant of DelimitedToInts that parses straight from a
+ * std::string_view (e.g. a line inside a MappedFile) into 'numbers'.
+ * Nothing is allocated per call once 'numbers' has grown to the longest line.
+ * @param s The input text; it does not need to be null-terminated.
+ * @param numbers Receives the parsed integers (appended, not cleared).
+ * @param backend Parser implementation; Auto picks the best SIMD backend the
+ * CPU supports, Scalar is the std::from_chars reference.
  */
-std::vector<std::vector<int>> GetVectorIntsFromTxt(const std::string &path)
+void DelimitedToInts(std::string_view s, std::vector<int> &numbers,
+					 ParseBackend backend = ParseBackend::Auto)
 {
-	std::string line;
-	// Attempt to open the file specified by 'path'
-	std::ifstream myfile(path);
-	std::vector<std::vector<int>> vec;
+	SelectIntParser(backend)(s, numbers);
+}
+
+/**
+ * @brief Converts every non-empty line of 'text' into a report appended to
+ * 'reports', using 'parse' for the numbers.
+ */
+void ParseReports(std::string_view text, IntParser parse, ReportTable &reports)
+{
+	// Scratch buffer reused for every line; each report is then copied into
+	// the table's contiguous value array.
+	std::vector<int> scratch;
+	ForEachLine(text,
+				[&](std::string_view line)
+				{
+					// Only process lines that are not empty
+					if (!line.empty())
+					{
+						scratch.clear();
+						parse(line, scratch);
+						reports.AddReport(scratch);
+					}
+				});
+}
 
-	if (myfile.is_open())
+/**
+ * @brief Converts each line of 'text' into a report using DelimitedToInts,
+ * appended to 'reports'. With a pool, the text is cut at newline boundaries
+ * into several spans per thread; each span is parsed into its own table on
+ * the pool and the tables are stitched on in input order.
+ * @param text The input text (e.g. a whole mapped file, or one block of it).
+ * @param reports Receives one report per non-empty line (appended).
+ * @param backend Parser implementation used for every line.
+ * @param pool Optional thread pool for parallel parsing.
+ * @param minSpanBytes Smallest span of text parsed as one parallel task.
+ */
+void AppendReportsFromText(std::string_view text, ReportTable &reports,
+						   ParseBackend backend = ParseBackend::Auto,
+						   WorkStealingPool *pool = nullptr,
+						   std::size_t minSpanBytes = std::size_t(1) << 20)
+{
+	AOC_PROFILE_SCOPE(Parse);
+	// Resolve the backend once rather than per line
+	IntParser parse = SelectIntParser(backend);
+	std::vector<std::string_view> spans;
+	if (pool)
 	{
-		// Read the file line by line until the end
-		while (getline(myfile, line))
-		{
-			// Only process lines that are not empty
-			if (!line.empty())
-			{
-				// Convert the line string into a vector of integers and add it
-				// to the main vector
-				vec.push_back(DelimitedToInts(line));
-			}
-		}
-		// Close the file stream after reading is complete
-		myfile.close();
+		spans = SplitAtLineBoundaries(text, pool->Size() * 4, minSpanBytes);
 	}
-	else
+	if (spans.size() <= 1)
 	{
-		// Output an error message if the file could not be opened
-		std::cout << "ERROR: Unable to open file at path: " << path
-				  << std::endl;
-		// Return hardcoded mock data for demonstration if the file is missing
-		return {{1, 2, 3}, {9, 6, 2}, {10, 7, 5, 2}};
+		ParseReports(text, parse, reports);
+		return;
 	}
+	std::vector<ReportTable> parts(spans.size());
+	pool->ParallelFor(spans.size(), 1,
+					  [&](std::size_t begin, std::size_t end, std::size_t)
+					  {
+						  for (std::size_t i = begin; i < end; i++)
+						  {
+							  ParseReports(spans[i], parse, parts[i]);
+						  }
+					  });
+	for (const ReportTable &part : parts)
+	{
+		reports.AppendTable(part);
+	}
+}
+
+/**
+ * @brief Converts each line of 'text' into a report (see
+ * AppendReportsFromText).
+ * @return ReportTable Flat storage holding one report per non-empty line.
+ */
+ReportTable ReportsFromText(std::string_view text,
+							ParseBackend backend = ParseBackend::Auto,
+							WorkStealingPool *pool = nullptr,
+							std::size_t minSpanBytes = std::size_t(1) << 20)
+{
+	ReportTable vec;
+	AppendReportsFromText(text, vec, backend, pool, minSpanBytes);
 	return vec;
 }
 
 /**
- * @brief Abstract base class defining the required interface for a "Day"
- * solver. Ensures all derived classes implement PartOne() and PartTwo().
+ * @brief Maps a file and converts each line into a report (see
+ * ReportsFromText). Lines are std::string_view spans into the mapping, so the
+ * text itself is never copied.
+ * @param path The file path
+ * @param reports Receives one report per non-empty line.
+ * @param backend Parser implementation used for every line.
+ * @param pool Optional thread pool for parallel parsing.
+ * @param minSpanBytes Smallest span of text parsed as one parallel task.
+ * @return false (reported on std::cerr) if the file can't be opened.
  */
-class IDay
+bool GetVectorIntsFromTxt(const std::string &path, ReportTable &reports,
+						  ParseBackend backend = ParseBackend::Auto,
+						  WorkStealingPool *pool = nullptr,
+						  std::size_t minSpanBytes = std::size_t(1) << 20)
 {
-public:
-	// Pure virtual functions: must be implemented by derived classes
-	virtual void PartOne() = 0;
-	virtual void PartTwo() = 0;
-	// Virtual destructor: essential for proper cleanup of derived class objects
-	virtual ~IDay() = default;
+	// Attempt to map the file specified by 'path'
+	MappedFile myfile(path);
+
+	if (!myfile.IsOpen())
+	{
+		std::cerr << "ERROR: Unable to open file at path: " << path << std::endl;
+		return false;
+	}
+	// The mapping is released when 'myfile' goes out of scope
+	reports = ReportsFromText(myfile.View(), backend, pool, minSpanBytes);
+	return true;
+}
+
+/**
+ * @brief How PartTwo decides whether one removal can make a report safe.
+ */
+enum class DampenerMode
+{
+	// Original path: try every removal with removeAtIndex + processSafe
+	Exhaustive,
+	// One pass: find the first bad step and only test the removals around it
+	SinglePass,
+	// Run both and report any report on which they disagree
+	Verify,
+};
+
+/**
+ * @brief Tunables for Day2. The defaults reproduce the original behaviour
+ * using the fastest implementations available on this host.
+ */
+struct Day2Options
+{
+	// Which DelimitedToInts backend parses the input
+	ParseBackend parseBackend = ParseBackend::Auto;
+	// Which "problem dampener" check PartTwo uses
+	DampenerMode dampener = DampenerMode::SinglePass;
+	// Classify reports in SIMD batches of equal length (report-batch.h)
+	bool batched = true;
+	// Check reports of up to kMaxFixedReport levels with kernels unrolled
+	// for their exact length (safety-kernel.h)
+	bool fixedShapes = true;
+	// Threads used to parse and classify reports: 1 runs inline, 0 uses one
+	// per hardware thread
+	std::size_t threads = 1;
+	// Smallest span of text parsed as one parallel task; the self-checks
+	// lower it so that their small inputs are parsed in parallel too
+	std::size_t parallelParseBytes = std::size_t(1) << 20;
+	// Input file read when no input was handed to Load()
+	std::string input = "../inputs/input-02.txt";
+	// How the input file is read: through the binary cache, with prefetch
+	LoadOptions load;
 };
 
 /**
@@ -120,47 +255,297 @@ public:
 class Day2 : public IDay
 {
 private:
+	Day2Options options;
+
 	// Storage for any accumulated sums (currently unused)
 	int part1Sum = 0;
 	int part2Sum = 0;
 
-	// Stores the input data: a vector of lines, where each line is a vector of
-	// integers
-	std::vector<std::vector<int>> data;
+	// Stores the input data: one report per line, all levels in a single
+	// contiguous array (see report-table.h)
+	ReportTable data;
+	// Set once a load has filled 'data' completely; PartOne then skips the
+	// file read
+	bool loaded = false;
+
+	// Reports found safe by PartOne; PartTwo then only revisits the others.
+	SafeMask part1Safe;
+	// First failing step PartOne found in each unsafe report, saturated at
+	// 255: PartTwo resumes its scan there. Empty after a batched PartOne,
+	// whose lockstep kernel only tells safe from unsafe.
+	std::vector<uint8_t> part1Step;
+
+	// Work-stealing pool for the parallel mode (null when running inline)
+	std::unique_ptr<WorkStealingPool> pool;
 
-	// Helper methods for core logic
-	bool processSafe(const std::vector<int> &nums);
+	// Sums countRange(begin, end) over every report range, inline or chunked
+	// on 'pool'.
+	template <typename Fn>
+	std::size_t CountReports(std::size_t count, Fn &&countRange);
+
+	// Helper methods for core logic. 'Report' is anything with size() and
+	// operator[]: a std::vector<int> or a ReportView into 'data'.
+	template <typename Report>
+	bool processSafe(const Report &nums);
+	// processSafe that also locates the first failure (see ClassifyReport)
+	template <typename Report>
+	SafetyResult Classify(const Report &nums);
+	template <typename Report>
+	bool processSafeReference(const Report &nums);
 	bool NumCheck(bool (*func)(int, int), int x, int y);
-	std::vector<int> removeAtIndex(int index, const std::vector<int> &nums);
+	template <typename Report>
+	std::vector<int> removeAtIndex(int index, const Report &nums);
+	template <typename Report>
+	std::pmr::vector<int> removeAtIndex(int index, const Report &nums,
+										std::pmr::memory_resource *arena);
+
+	// Part Two checks: is 'nums' safe after removing at most one element?
+	// 'first', when known, is the report's Classify result.
+	template <typename Report>
+	bool processSafeDampened(const Report &nums,
+							 const SafetyResult *first = nullptr);
+	template <typename Report>
+	bool processSafeByRemoval(const Report &nums);
+	template <typename Report>
+	bool processSafeSinglePass(const Report &nums, const SafetyResult *first);
 
 public:
+	explicit Day2(const Day2Options &options = Day2Options())
+		: options(options)
+	{
+		if (options.threads != 1)
+		{
+			pool = std::make_unique<WorkStealingPool>(options.threads);
+		}
+	}
+
 	// Public interface required by IDay
-	void PartOne() override;
-	void PartTwo() override;
+	bool Load(std::string_view input) override;
+	bool LoadFile(const std::string &path, const LoadOptions &load) override;
+	int64_t PartOne() override;
+	int64_t PartTwo() override;
+
+	// Solves both parts in one pass over 'in' without storing the reports
+	bool Stream(std::FILE *in, int64_t &part1, int64_t &part2);
+
+	// Checks every parser, safety kernel, dampener and solver configuration
+	// against DelimitedToInts, processSafeReference and removeAtIndex.
+	bool SelfCheck(std::string_view input, std::ostream &log) override;
 };
 
+bool Day2::Load(std::string_view input)
+{
+	data = ReportsFromText(input, options.parseBackend, pool.get(),
+						   options.parallelParseBytes);
+	part1Safe.Reset(0);
+	part1Step.clear();
+	loaded = true;
+	// Any text parses: each line is a report of whatever integers it holds
+	return true;
+}
+
+/**
+ * @brief Loads 'path', through the binary cache when 'load.cache' is set. The
+ * cache holds the table's two CSR columns: the report offsets (which
+ * delta-pack to the few bits a report length needs) and the levels.
+ */
+bool Day2::LoadFile(const std::string &path, const LoadOptions &load)
+{
+	loaded = false;
+	CacheSource source;
+	bool cacheable = load.cache && StatCacheSource(path, source);
+	const std::string cachePath = ColumnCachePath(path);
+	ColumnCache cache;
+	if (cacheable && cache.Open(cachePath, CacheKind::Day2Reports, source) &&
+		cache.Columns() == 2)
+	{
+		AOC_PROFILE_SCOPE(Read);
+		std::vector<uint64_t> offsets;
+		cache.Decode(0, offsets);
+		// Decode the levels straight into the narrowest width that holds them
+		auto assign = [&](auto width)
+		{
+			std::vector<decltype(width)> levels;
+			cache.Decode(1, levels);
+			return data.AssignColumns(std::move(levels), std::move(offsets));
+		};
+		int64_t lo = cache.MinValue(1), hi = cache.MaxValue(1);
+		bool assigned =
+			lo >= INT8_MIN && hi <= INT8_MAX	 ? assign(int8_t())
+			: lo >= INT16_MIN && hi <= INT16_MAX ? assign(int16_t())
+			: lo >= INT32_MIN && hi <= INT32_MAX ? assign(int32_t())
+												 : false;
+		if (assigned)
+		{
+			part1Safe.Reset(0);
+			part1Step.clear();
+			loaded = true;
+			return true;
+		}
+	}
+
+	auto append = [&](std::string_view text)
+	{
+		AppendReportsFromText(text, data, options.parseBackend, pool.get(),
+							  options.parallelParseBytes);
+	};
+	Compression compression = FileCompression(path);
+	const bool streamed = IsStreamOnly(path);
+	if (streamed || compression != Compression::None || load.prefetch)
+	{
+		// Parse each block as soon as it arrives (decompressed, if the file
+		// is compressed), while the reads after it are still in flight. A
+		// pipe or FIFO is read in one pass, sniffed as it goes.
+		data = ReportTable();
+		part1Safe.Reset(0);
+		part1Step.clear();
+		bool ok = streamed ? ReadStreamBlocks(path, append)
+				  : compression != Compression::None
+					  ? ReadCompressedBlocks(path, compression, load.prefetch,
+											 load.prefetchBackend, pool.get(),
+											 append)
+					  : ReadLineBlocks(path, load.prefetchBackend, append);
+		if (!ok)
+		{
+			return false;
+		}
+		loaded = true;
+	}
+	else
+	{
+		if (!GetVectorIntsFromTxt(path, data, options.parseBackend, pool.get(),
+								  options.parallelParseBytes))
+		{
+			return false;
+		}
+		part1Safe.Reset(0);
+		part1Step.clear();
+		loaded = true;
+	}
+	if (cacheable)
+	{
+		ColumnCacheWriter writer;
+		data.Visit(
+			[&](const auto &reports)
+			{
+				writer.AddColumn(reports.offsets.data(), reports.offsets.size());
+				writer.AddColumn(reports.values.data(), reports.values.size());
+			});
+		writer.Write(cachePath, CacheKind::Day2Reports, 0, source);
+	}
+	return true;
+}
+
+// Tallies why Part 1 rejected a report (--profile builds).
+static void CountFailure(StepFailure failure)
+{
+	switch (failure)
+	{
+	case StepFailure::Flat:
+		AOC_PROFILE_COUNT(UnsafeFlat, 1);
+		break;
+	case StepFailure::Reversed:
+		AOC_PROFILE_COUNT(UnsafeReversed, 1);
+		break;
+	case StepFailure::TooFar:
+		AOC_PROFILE_COUNT(UnsafeTooFar, 1);
+		break;
+	default:
+		break;
+	}
+}
+
 /**
  * @brief Solves Part One of the problem.
  * Finds the count of sequences in the input that are inherently "safe".
  */
-void Day2::PartOne()
+int64_t Day2::PartOne()
 {
-	// 1. Load the input data from the file
-	data = GetVectorIntsFromTxt("../inputs/input-02.txt");
-
-	int safeTotal = 0;
-	// 2. Iterate over each sequence (inner vector) in the loaded data
-	for (const std::vector<int> &nums : data)
+	// 1. Load the input data from the file, unless it was handed to Load()
+	if (!loaded && !LoadFile(options.input, options.load))
 	{
-		// 3. Check if the sequence is safe according to the rules
-		if (processSafe(nums))
+		return 0;
+	}
+	int64_t safeTotal = 0;
+	{
+		// Started after the load, so its hardware counts are processSafe's own
+		AOC_PROFILE_SCOPE(Classify);
+		if (options.batched)
 		{
-			safeTotal++;
+			// 2. Check the reports in lockstep SIMD batches; the per-report
+			// results are kept for PartTwo
+			part1Safe.Reset(data.Count());
+			part1Step.clear();
+			data.Visit(
+				[&](const auto &reports)
+				{
+					safeTotal = static_cast<int64_t>(CountReports(
+						reports.Count(),
+						[&](std::size_t begin, std::size_t end)
+						{
+							ClassifyBatchedRange(reports, begin, end, part1Safe);
+							return part1Safe.CountSet(begin, end);
+						}));
+				});
+		}
+		else
+		{
+			// 2. Iterate over each report, visiting the table once so the loop
+			// is compiled for its concrete value width. Each report's verdict
+			// and first failure are kept for PartTwo.
+			part1Safe.Reset(data.Count());
+			part1Step.assign(data.Count(), 0);
+			data.Visit(
+				[&](const auto &reports)
+				{
+					safeTotal = static_cast<int64_t>(CountReports(
+						reports.Count(),
+						[&](std::size_t begin, std::size_t end)
+						{
+							std::size_t safe = 0;
+							for (std::size_t r = begin; r < end; r++)
+							{
+								// 3. Check if the sequence is safe according to
+								// the rules
+								SafetyResult result = Classify(reports[r]);
+								if (result.Safe())
+								{
+									part1Safe.Set(r);
+									safe++;
+									continue;
+								}
+								part1Step[r] = static_cast<uint8_t>(
+									std::min<std::size_t>(result.step, 255));
+								CountFailure(result.failure);
+							}
+							return safe;
+						}));
+				});
 		}
 	}
+#ifdef AOC_PROFILE
+	// The batch kernels only say safe or not. Tally why the others failed
+	// here, outside the Classify phase, so its figures stay the kernels' own.
+	if (options.batched && profile::Enabled())
+	{
+		data.Visit(
+			[&](const auto &reports)
+			{
+				for (std::size_t r = 0; r < reports.Count(); r++)
+				{
+					if (!part1Safe.Test(r))
+					{
+						auto report = reports[r];
+						CountFailure(
+							ClassifyReport(report.data(), report.size()).failure);
+					}
+				}
+			});
+	}
+#endif
 
-	// 4. Output the final result
-	std::cout << "Part 1: " << safeTotal << std::endl;
+	// 4. Return the final result
+	return safeTotal;
 }
 
 /**
@@ -168,43 +553,175 @@ void Day2::PartOne()
  * Finds the count of sequences that are either safe, or can be made safe by
  * removing exactly one element.
  */
-void Day2::PartTwo()
+int64_t Day2::PartTwo()
 {
-	int safeTotal = 0;
+	AOC_PROFILE_SCOPE(Dampen);
+	int64_t safeTotal = 0;
 	// Iterate over the data (which was loaded in PartOne)
-	for (std::vector<int> &nums : data)
-	{
-		// 1. Check if the sequence is already safe
-		if (!processSafe(nums))
+	data.Visit(
+		[&](const auto &reports)
 		{
-			// 2. If unsafe, try removing each element one by one
-			for (size_t i = 0; i != nums.size(); i++)
-			{
-				// Create a temporary sequence with the element at index 'i'
-				// removed
-				std::vector<int> temp = removeAtIndex(i, nums);
-
-				// Check if the modified sequence is now safe
-				if (processSafe(temp))
+			// Consume PartOne's results when there are some: its safe reports
+			// count as is, and the rescan of the others starts at their first
+			// failure when PartOne located it
+			bool known = part1Safe.Size() == reports.Count();
+			bool located = part1Step.size() == reports.Count();
+			safeTotal = static_cast<int64_t>(CountReports(
+				reports.Count(),
+				[&](std::size_t begin, std::size_t end)
 				{
-					safeTotal++;
-					// Found a valid removal, stop trying other removals for
-					// this original sequence
-					break;
-				}
-			}
+					std::size_t safe = 0;
+					for (std::size_t r = begin; r < end; r++)
+					{
+						// Safe as-is, or safe once the dampener removes one
+						// level
+						if (known && part1Safe.Test(r))
+						{
+							safe++;
+							continue;
+						}
+						AOC_PROFILE_COUNT(DampenedReports, 1);
+						auto report = reports[r];
+						SafetyResult first;
+						if (located)
+						{
+							first = ClassifyReport(report.data(), report.size(),
+												   part1Step[r]);
+						}
+						if (processSafeDampened(report, located ? &first
+																: nullptr))
+						{
+							safe++;
+						}
+					}
+					return safe;
+				}));
+		});
+	return safeTotal;
+}
+
+/**
+ * @brief Online variant of PartOne + PartTwo for inputs that arrive on a pipe
+ * or are too large to keep. Each line is parsed into one reused scratch
+ * vector and classified for both parts as soon as it is read, so memory is
+ * one LineStream chunk plus the longest report, whatever the input size.
+ * @param in The stream to read (a file, or stdin); it is not closed.
+ * @param part1 Receives the number of safe reports.
+ * @param part2 Receives the number of reports safe with the dampener.
+ * @return false if reading failed part-way through.
+ */
+bool Day2::Stream(std::FILE *in, int64_t &part1, int64_t &part2)
+{
+	// Compressed input is recognised from its first bytes, even on a pipe
+	StdioSource stdio(in);
+	PeekedSource source(stdio);
+	Compression compression = source.Detect();
+	std::unique_ptr<ByteSource> decompressor =
+		MakeDecompressor(compression, source);
+	if (compression != Compression::None && !decompressor)
+	{
+		std::cerr << "ERROR: Input is " << CompressionName(compression)
+				  << "-compressed, but this build has no support for it"
+				  << std::endl;
+		return false;
+	}
+	LineStream lines(decompressor ? *decompressor : source);
+	IntParser parse = SelectIntParser(options.parseBackend);
+	std::vector<int> scratch;
+	part1 = 0;
+	part2 = 0;
+
+	std::string_view line;
+	while (lines.NextLine(line))
+	{
+		if (line.empty())
+		{
+			continue;
 		}
-		else
+		// Each step is timed in its own phase; the line reads are timed by
+		// LineStream (Read) and the decompressor (Decompress)
+		{
+			AOC_PROFILE_SCOPE(Parse);
+			scratch.clear();
+			parse(line, scratch);
+		}
+		// One scan serves both parts: the dampener resumes at the failure
+		SafetyResult result;
+		{
+			AOC_PROFILE_SCOPE(Classify);
+			result = Classify(scratch);
+		}
+		if (result.Safe())
+		{
+			part1++;
+			part2++;
+			continue;
+		}
+		CountFailure(result.failure);
+		AOC_PROFILE_COUNT(DampenedReports, 1);
+		bool dampened;
 		{
-			// If it was already safe, count it
-			safeTotal++;
+			AOC_PROFILE_SCOPE(Dampen);
+			dampened = processSafeDampened(scratch, &result);
+		}
+		if (dampened)
+		{
+			part2++;
 		}
 	}
-	std::cout << "Part 2: " << safeTotal << std::endl;
+	if (lines.Failed())
+	{
+		std::cerr << "ERROR: Read failed after " << lines.BytesRead()
+				  << " bytes" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Runs countRange over all 'count' reports and sums the results.
+ * Inline when there is no pool; otherwise the reports are cut into many more
+ * chunks than threads (so the pool can steal around long reports), each a
+ * multiple of 64 reports so no two chunks share a SafeMask word. Every worker
+ * accumulates into its own slot, so nothing is shared on the hot path.
+ */
+template <typename Fn>
+std::size_t Day2::CountReports(std::size_t count, Fn &&countRange)
+{
+	if (!pool)
+	{
+		return countRange(0, count);
+	}
+	constexpr std::size_t kMinChunk = 1024;
+	std::size_t grain = count / (pool->Size() * 16);
+	grain = ((std::max(grain, kMinChunk) + 63) / 64) * 64;
+	return pool->ParallelSum<std::size_t>(count, grain, countRange);
+}
+
+/**
+ * @brief Checks if a given sequence of numbers is "safe" (see
+ * processSafeReference for the rules).
+ * Compatibility wrapper over the devirtualised IsSafeReport kernel in
+ * safety-kernel.h; 'Report' must also expose data().
+ * @param nums The sequence of integers to check.
+ * @return true if the sequence is safe, false otherwise.
+ */
+template <typename Report>
+bool Day2::processSafe(const Report &nums)
+{
+	return options.fixedShapes ? IsSafeShaped(nums.data(), nums.size())
+							   : IsSafeReport(nums.data(), nums.size());
+}
+
+template <typename Report>
+SafetyResult Day2::Classify(const Report &nums)
+{
+	return options.fixedShapes ? ClassifyShaped(nums.data(), nums.size())
+							   : ClassifyReport(nums.data(), nums.size());
 }
 
 /**
- * @brief Checks if a given sequence of numbers is "safe".
+ * @brief Original safety check, kept as the reference for IsSafeReport.
  * A sequence is safe if:
  * 1. The trend (increasing or decreasing) is set by the first two elements.
  * 2. Every subsequent adjacent pair follows that same trend.
@@ -212,7 +729,8 @@ void Day2::PartTwo()
  * @param nums The sequence of integers to check.
  * @return true if the sequence is safe, false otherwise.
  */
-bool Day2::processSafe(const std::vector<int> &nums)
+template <typename Report>
+bool Day2::processSafeReference(const Report &nums)
 {
 	// A sequence with 0 or 1 element is vacuously safe
 	if (nums.size() < 2)
@@ -264,22 +782,44 @@ bool Day2::NumCheck(bool (*func)(int, int), int x, int y)
 {
 	// Check 1: Does the pair follow the required trend? (func(x, y))
 	// Check 2: Is the absolute difference between them less than or equal to 3?
-	return func(x, y) && (std::abs(x - y) <= 3);
+	// (in 64 bits: two int levels may lie up to 2^32 - 1 apart)
+	return func(x, y) && (std::abs(int64_t(x) - y) <= 3);
 }
 
 /**
  * @brief Creates a new vector by removing the element at the specified index.
  * @param index The zero-based index of the element to remove.
- * @param nums The original vector.
+ * @param nums The original report.
  * @return std::vector<int> A new vector without the element at 'index'.
  */
-std::vector<int> Day2::removeAtIndex(int index, const std::vector<int> &nums)
+template <typename Report>
+std::vector<int> Day2::removeAtIndex(int index, const Report &nums)
 {
 	std::vector<int> temp;
 	for (size_t i = 0; i < nums.size(); i++)
 	{
 		// Copy all elements EXCEPT the one at the specified index
-		if (i != index)
+		if (i != static_cast<size_t>(index))
+		{
+			temp.push_back(nums[i]);
+		}
+	}
+	return temp;
+}
+
+/**
+ * @brief removeAtIndex drawing the new vector from 'arena' instead of the
+ * heap, sized exactly up front so it never reallocates.
+ */
+template <typename Report>
+std::pmr::vector<int> Day2::removeAtIndex(int index, const Report &nums,
+										  std::pmr::memory_resource *arena)
+{
+	std::pmr::vector<int> temp(arena);
+	temp.reserve(nums.size() > 0 ? nums.size() - 1 : 0);
+	for (size_t i = 0; i < nums.size(); i++)
+	{
+		if (i != static_cast<size_t>(index))
 		{
 			temp.push_back(nums[i]);
 		}
@@ -287,22 +827,431 @@ std::vector<int> Day2::removeAtIndex(int index, const std::vector<int> &nums)
 	return temp;
 }
 
+/**
+ * @brief Dispatches to the Part Two check selected in the options.
+ * @param nums The report to check.
+ * @return true if the report is safe, or can be made safe by removing exactly
+ * one element.
+ */
+template <typename Report>
+bool Day2::processSafeDampened(const Report &nums, const SafetyResult *first)
+{
+	switch (options.dampener)
+	{
+	case DampenerMode::Exhaustive:
+		return processSafeByRemoval(nums);
+	case DampenerMode::Verify:
+	{
+		bool reference = processSafeByRemoval(nums);
+		if (processSafeSinglePass(nums, first) != reference)
+		{
+			std::cerr << "Dampener mismatch on report:";
+			for (size_t i = 0; i < nums.size(); i++)
+			{
+				std::cerr << ' ' << nums[i];
+			}
+			std::cerr << std::endl;
+		}
+		return reference;
+	}
+	default:
+		return processSafeSinglePass(nums, first);
+	}
+}
+
+/**
+ * @brief Original Part Two check: if the report is unsafe, try removing each
+ * element one by one. Costs O(n^2) time, so it is kept as the reference for
+ * processSafeSinglePass. The candidates come from a per-thread arena that is
+ * reset for each report, so they don't touch the heap.
+ * @param nums The report to check.
+ */
+template <typename Report>
+bool Day2::processSafeByRemoval(const Report &nums)
+{
+	// 1. Check if the sequence is already safe
+	if (processSafe(nums))
+	{
+		return true;
+	}
+	// Reports are short, so all n candidates normally fit the inline buffer
+	thread_local ScratchArena<> arena;
+	arena.Reset();
+	// 2. If unsafe, try removing each element one by one
+	for (size_t i = 0; i != nums.size(); i++)
+	{
+		// Create a temporary sequence with the element at index 'i' removed
+		std::pmr::vector<int> temp = removeAtIndex(i, nums, arena.Resource());
+		AOC_PROFILE_COUNT(CandidatesTried, 1);
+
+		// Check if the modified sequence is now safe
+		if (processSafe(temp))
+		{
+			// Found a valid removal, stop trying other removals
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief O(n) Part Two check with no temporary vectors (see
+ * SafeWithOneRemoval): once the first failing step is known, only the two
+ * levels either side of it, or the first two levels, are worth removing,
+ * and each rescan starts next to the removal.
+ * With a known 'first' (PartOne's result) the failure is not searched for
+ * again. Otherwise short reports use the kernel unrolled for their length
+ * (IsSafeDampenedFixed), which beats locating the failure first, and longer
+ * ones are classified here.
+ * @param nums The report to check.
+ * @param first The report's Classify result, or null.
+ */
+template <typename Report>
+bool Day2::processSafeSinglePass(const Report &nums, const SafetyResult *first)
+{
+	if (first)
+	{
+		return SafeWithOneRemoval(nums.data(), nums.size(), *first);
+	}
+	auto classifyThenCheck = [&]
+	{
+		return SafeWithOneRemoval(nums.data(), nums.size(),
+								  ClassifyReport(nums.data(), nums.size()));
+	};
+	if (!options.fixedShapes)
+	{
+		return classifyThenCheck();
+	}
+	return IsSafeDampenedShaped(nums.data(), nums.size(), classifyThenCheck);
+}
+
+/**
+ * @brief Differential check of 'input' (see IDay::SelfCheck). Each line is
+ * parsed by every backend and compared to DelimitedToInts; its safety and
+ * dampener verdicts from every kernel are compared to processSafeReference
+ * on the report and on each removeAtIndex candidate. Then every solver
+ * configuration, --stream and the shard merge must reproduce the reference
+ * totals.
+ */
+bool Day2::SelfCheck(std::string_view input, std::ostream &log)
+{
+	bool ok = true;
+	auto check = [&](const std::string &what, bool agrees,
+					 std::string_view line = {})
+	{
+		if (!agrees)
+		{
+			log << "day2: " << what << " disagrees with the reference";
+			if (!line.empty())
+			{
+				log << " on " << std::quoted(std::string(line));
+			}
+			log << std::endl;
+			ok = false;
+		}
+	};
+
+	int64_t want1 = 0, want2 = 0;
+	std::vector<int> parsed;
+	ForEachLine(
+		input,
+		[&](std::string_view line)
+		{
+			if (line.empty())
+			{
+				return;
+			}
+			std::vector<int> nums = DelimitedToInts(std::string(line));
+			for (ParseBackend backend : kParseBackends)
+			{
+				if (ParseBackendSupported(backend))
+				{
+					parsed.clear();
+					DelimitedToInts(line, parsed, backend);
+					check(std::string("parser ") + ParseBackendName(backend),
+						  parsed == nums, line);
+				}
+			}
+
+			bool safe = processSafeReference(nums);
+			bool fixable = safe;
+			for (size_t i = 0; !fixable && i < nums.size(); i++)
+			{
+				fixable = processSafeReference(removeAtIndex(int(i), nums));
+			}
+			want1 += safe;
+			want2 += fixable;
+
+			const int *levels = nums.data();
+			const std::size_t n = nums.size();
+			SafetyResult first = ClassifyReport(levels, n);
+			check("IsSafeReport", IsSafeReport(levels, n) == safe, line);
+			check("IsSafeShaped", IsSafeShaped(levels, n) == safe, line);
+			check("ClassifyReport", first.Safe() == safe, line);
+			check("ClassifyShaped", ClassifyShaped(levels, n).Safe() == safe,
+				  line);
+			check("SafeWithOneRemoval",
+				  SafeWithOneRemoval(levels, n, first) == fixable, line);
+			check("IsSafeDampenedShaped",
+				  IsSafeDampenedShaped(levels, n,
+									   [&] {
+										   return SafeWithOneRemoval(levels, n,
+																	 first);
+									   }) == fixable,
+				  line);
+		});
+
+	// Whole-input paths: table storage, batching, threads, PartTwo without
+	// PartOne's results
+	struct Variant
+	{
+		const char *name;
+		Day2Options options;
+		bool partTwoFirst;
+	};
+	std::vector<Variant> variants;
+	auto add = [&](const char *name, bool partTwoFirst, auto &&tweak)
+	{
+		Variant variant{name, Day2Options(), partTwoFirst};
+		tweak(variant.options);
+		variants.push_back(variant);
+	};
+	add("defaults", false, [](Day2Options &) {});
+	add("part two first", true, [](Day2Options &) {});
+	add("exhaustive dampener", false,
+		[](Day2Options &o) { o.dampener = DampenerMode::Exhaustive; });
+	add("unbatched", false, [](Day2Options &o) { o.batched = false; });
+	add("unbatched, part two first", true,
+		[](Day2Options &o) { o.batched = false; });
+	add("no fixed shapes", false, [](Day2Options &o) { o.fixedShapes = false; });
+	add("unbatched, no fixed shapes", false,
+		[](Day2Options &o)
+		{
+			o.batched = false;
+			o.fixedShapes = false;
+		});
+	// Threaded variants drop the parallel parse threshold, so that even a
+	// few lines are parsed in several spans
+	auto threaded = [](Day2Options &o)
+	{
+		o.threads = 3;
+		o.parallelParseBytes = 16;
+	};
+	add("3 threads", false, threaded);
+	add("3 threads, unbatched", false,
+		[&](Day2Options &o)
+		{
+			threaded(o);
+			o.batched = false;
+		});
+	for (ParseBackend backend : kParseBackends)
+	{
+		if (ParseBackendSupported(backend))
+		{
+			variants.push_back({ParseBackendName(backend), Day2Options(), false});
+			variants.back().options.parseBackend = backend;
+		}
+	}
+	for (const Variant &variant : variants)
+	{
+		Day2 solver(variant.options);
+		solver.Load(input);
+		int64_t part1 = 0, part2 = 0;
+		if (variant.partTwoFirst)
+		{
+			part2 = solver.PartTwo();
+			part1 = solver.PartOne();
+		}
+		else
+		{
+			part1 = solver.PartOne();
+			part2 = solver.PartTwo();
+		}
+		check(variant.name, part1 == want1 && part2 == want2);
+	}
+
+#if AOC_HAVE_FMEMOPEN
+	// --stream, fed from memory (fmemopen rejects an empty buffer)
+	if (!input.empty())
+	{
+		std::string copy(input);
+		std::FILE *in = fmemopen(copy.data(), copy.size(), "r");
+		int64_t part1 = 0, part2 = 0;
+		check("stream", in && Stream(in, part1, part2) && part1 == want1 &&
+							part2 == want2);
+		if (in)
+		{
+			std::fclose(in);
+		}
+	}
+#endif
+
+	// Two shards cut at a line map and combine to the same totals
+	std::size_t cut = input.find('\n', input.size() / 2);
+	cut = cut == std::string_view::npos ? input.size() : cut + 1;
+	Day2 head, tail;
+	head.Load(input.substr(0, cut));
+	tail.Load(input.substr(cut));
+	int64_t part1 = 0, part2 = 0;
+	Combine({head.Map(), tail.Map()}, part1, part2);
+	check("map/combine", part1 == want1 && part2 == want2);
+	return ok;
+}
+
+// Factory used by the multi-day runner (runner.cpp).
+std::unique_ptr<IDay> MakeDay2()
+{
+	return std::make_unique<Day2>();
+}
+
 // --- main Function (Entry Point) ---
+// Left out when this file is linked into the runner, which has its own main.
+#ifndef AOC_RUNNER
+AOC_PROFILE_ALLOCATION_HOOK()
 
-int main()
+int main(int argc, char **argv)
 {
+	Day2Options options;
+	// Input for the single-pass streaming mode; empty runs the usual parts
+	std::string streamPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		std::string_view value = i + 1 < argc ? argv[i + 1] : "";
+		// --parser <auto|scalar|sse4.2|avx2|neon> selects the parse backend
+		if (arg == "--parser" &&
+			ParseBackendFromName(value, options.parseBackend))
+		{
+			i++;
+		}
+		// --dampener <exhaustive|single-pass|verify> selects the Part 2 check
+		else if (arg == "--dampener" &&
+				 (value == "exhaustive" || value == "single-pass" ||
+				  value == "verify"))
+		{
+			options.dampener = value == "exhaustive" ? DampenerMode::Exhaustive
+							   : value == "verify"	 ? DampenerMode::Verify
+													 : DampenerMode::SinglePass;
+			i++;
+		}
+		// --threads <n> parses and classifies on n threads (0 = all cores)
+		else if (arg == "--threads" && !value.empty() &&
+				 std::from_chars(value.data(), value.data() + value.size(),
+								 options.threads)
+						 .ec == std::errc())
+		{
+			i++;
+		}
+		// --batch <on|off> toggles SIMD batch classification
+		else if (arg == "--batch" && (value == "on" || value == "off"))
+		{
+			options.batched = value == "on";
+			i++;
+		}
+		// --shapes <on|off> toggles the per-length unrolled kernels
+		else if (arg == "--shapes" && (value == "on" || value == "off"))
+		{
+			options.fixedShapes = value == "on";
+			i++;
+		}
+		// --input <path> reads another input file (plain, gzip or zstd)
+		else if (arg == "--input" && !value.empty())
+		{
+			options.input = value;
+			i++;
+		}
+		// --stream <path|-> solves both parts online from a file or stdin
+		else if (arg == "--stream" && !value.empty())
+		{
+			streamPath = value;
+			i++;
+		}
+		// --cache reuses the parsed reports saved next to the input file
+		else if (arg == "--cache")
+		{
+			options.load.cache = true;
+		}
+		// --prefetch <auto|io_uring|thread> reads with asynchronous prefetch
+		else if (arg == "--prefetch" &&
+				 PrefetchBackendFromName(value, options.load.prefetchBackend))
+		{
+			options.load.prefetch = true;
+			i++;
+		}
+		// --profile prints phase timings and counters as JSON to stderr
+		else if (arg == "--profile")
+		{
+#ifdef AOC_PROFILE
+			profile::Enable();
+#else
+			std::cerr << "--profile needs a build with -DAOC_PROFILE" << std::endl;
+			return 1;
+#endif
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0]
+					  << " [--parser auto|scalar|sse4.2|avx2|neon]"
+						 " [--dampener exhaustive|single-pass|verify]"
+						 " [--batch on|off] [--shapes on|off] [--threads n]"
+						 " [--input path] [--stream path|-] [--cache]"
+						 " [--prefetch auto|io_uring|thread] [--profile]"
+					  << std::endl;
+			return 1;
+		}
+	}
+
+	AOC_PROFILE_REPORT("day2");
+
 	// Instantiate the solver class for Day 2
-	Day2 solver;
+	Day2 solver(options);
+
+	if (!streamPath.empty())
+	{
+		std::FILE *in =
+			streamPath == "-" ? stdin : std::fopen(streamPath.c_str(), "rb");
+		if (!in)
+		{
+			std::cerr << "ERROR: Unable to open file at path: " << streamPath
+					  << std::endl;
+			return 1;
+		}
+		int64_t part1 = 0, part2 = 0;
+		bool ok = solver.Stream(in, part1, part2);
+		if (in != stdin)
+		{
+			std::fclose(in);
+		}
+		if (!ok)
+		{
+			return 1;
+		}
+		Reporter reporter;
+		reporter.Part(1, part1);
+		reporter.Part(2, part2);
+		return 0;
+	}
+
+	// A missing input is an error, not an answer of 0 (any text is a valid
+	// list of reports)
+	if (!solver.LoadFile(options.input, options.load))
+	{
+		return 1;
+	}
+
+	// Answers are collected and written once at the end
+	Reporter reporter;
 
 	// Run Part 1
-	std::cout << "Running Part 1:\n";
-	solver.PartOne();
-	std::cout << "\n";
+	reporter.Line("Running Part 1:");
+	reporter.Part(1, solver.PartOne());
+	reporter.Line("");
 
-	// Run Part 2. It uses the 'data' vector already populated by PartOne.
-	std::cout << "Running Part 2:\n";
-	solver.PartTwo();
-	std::cout << "\n";
+	// Run Part 2. It uses the 'data' table already populated by PartOne.
+	reporter.Line("Running Part 2:");
+	reporter.Part(2, solver.PartTwo());
+	reporter.Line("");
 
 	return 0;
 }
+#endif // AOC_RUNNER
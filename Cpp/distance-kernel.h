@@ -0,0 +1,118 @@
+#ifndef AOC_DISTANCE_KERNEL_H
+#define AOC_DISTANCE_KERNEL_H
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For int32_t, uint32_t, uint64_t, int64_t
+
+#include "simd-target.h" // For AOC_TARGET, AOC_X86, AOC_NEON
+#include "thread-pool.h" // For WorkStealingPool
+
+/**
+ * Day 1's total distance, sum(|a[i] - b[i]|), as a vectorised and
+ * multithreaded reduction. The absolute difference of two int32_t always
+ * fits in a uint32_t, and every lane accumulates into 64 bits, so no input
+ * range can overflow the sum (short of 2^32 rows of maximal differences).
+ */
+
+namespace distance_detail
+{
+inline uint64_t SumAbsDiffScalar(const int32_t *a, const int32_t *b,
+								 std::size_t n)
+{
+	uint64_t sum = 0;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		sum += a[i] < b[i] ? uint64_t(uint32_t(b[i]) - uint32_t(a[i]))
+						   : uint64_t(uint32_t(a[i]) - uint32_t(b[i]));
+	}
+	return sum;
+}
+
+#if AOC_X86
+// 8 pairs per step: |a - b| as uint32 via the cmpgt sign mask, widened into
+// four 64-bit lanes. Two accumulators hide the add latency.
+AOC_TARGET("avx2")
+inline uint64_t SumAbsDiffAvx2(const int32_t *a, const int32_t *b,
+							   std::size_t n)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc0 = zero, acc1 = zero;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+		__m256i d = _mm256_sub_epi32(x, y);
+		// (d ^ m) - m negates the lanes where b > a (mod 2^32)
+		__m256i m = _mm256_cmpgt_epi32(y, x);
+		d = _mm256_sub_epi32(_mm256_xor_si256(d, m), m);
+		acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(d, zero));
+		acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(d, zero));
+	}
+	alignas(32) uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i *>(lanes),
+					   _mm256_add_epi64(acc0, acc1));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+		   SumAbsDiffScalar(a + i, b + i, n - i);
+}
+#endif // AOC_X86
+
+#if AOC_NEON
+// 4 pairs per step: vabdq gives |a - b| exactly when read as unsigned, and
+// vpadalq folds adjacent lanes into 64-bit accumulators.
+inline uint64_t SumAbsDiffNeon(const int32_t *a, const int32_t *b,
+							   std::size_t n)
+{
+	uint64x2_t acc = vdupq_n_u64(0);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		uint32x4_t d = vreinterpretq_u32_s32(
+			vabdq_s32(vld1q_s32(a + i), vld1q_s32(b + i)));
+		acc = vpadalq_u32(acc, d);
+	}
+	return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1) +
+		   SumAbsDiffScalar(a + i, b + i, n - i);
+}
+#endif // AOC_NEON
+
+using SumAbsDiffFn = uint64_t (*)(const int32_t *, const int32_t *,
+								  std::size_t);
+
+inline SumAbsDiffFn SelectSumAbsDiff()
+{
+#if AOC_X86
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SumAbsDiffAvx2;
+	}
+#endif
+#if AOC_NEON
+	return SumAbsDiffNeon;
+#else
+	return SumAbsDiffScalar;
+#endif
+}
+} // namespace distance_detail
+
+/**
+ * @brief sum(|a[i] - b[i]|) over n pairs, with the widest kernel the CPU
+ * supports. With a pool, large inputs are cut into chunks of 1M pairs that
+ * every thread reduces into its own accumulator (ParallelSum).
+ */
+inline int64_t ColumnDistance(const int32_t *a, const int32_t *b,
+							  std::size_t n, WorkStealingPool *pool = nullptr)
+{
+	static const distance_detail::SumAbsDiffFn kernel =
+		distance_detail::SelectSumAbsDiff();
+	constexpr std::size_t kGrain = std::size_t(1) << 20;
+	if (!pool || n <= kGrain)
+	{
+		return static_cast<int64_t>(kernel(a, b, n));
+	}
+	return static_cast<int64_t>(pool->ParallelSum<uint64_t>(
+		n, kGrain, [&](std::size_t begin, std::size_t end)
+		{ return kernel(a + begin, b + begin, end - begin); }));
+}
+
+#endif // AOC_DISTANCE_KERNEL_H
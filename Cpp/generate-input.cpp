@@ -0,0 +1,167 @@
+// Writes synthetic puzzle inputs of any size (see synthetic-input.h).
+//
+// Build (from Cpp/):
+//   g++ -std=c++17 -O2 generate-input.cpp -o generate-input
+//
+// Usage:
+//   generate-input day1 --lines n [--min v] [--max v] [--duplicates rate]
+//                       [--seed s] [--out path]
+//   generate-input day2 --lines n [--min-length n] [--max-length n]
+//                       [--safe fraction] [--fixable fraction]
+//                       [--seed s] [--out path]
+// Output goes to stdout unless --out is given, in blocks of 64K lines, so
+// memory use doesn't grow with --lines.
+
+#include <charconv>	   // For std::from_chars
+#include <cstdint>	   // For uint64_t
+#include <cstdio>	   // For std::FILE, std::fopen, std::fwrite
+#include <cstdlib>	   // For std::strtod
+#include <iostream>	   // For std::cerr
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view
+
+#include "synthetic-input.h" // For synthetic::Day1Generator, Day2Generator
+
+template <typename T>
+static bool ParseNumber(std::string_view text, T &value)
+{
+	return !text.empty() &&
+		   std::from_chars(text.data(), text.data() + text.size(), value).ec ==
+			   std::errc();
+}
+
+static bool ParseFraction(const char *text, double &value)
+{
+	char *end = nullptr;
+	value = std::strtod(text, &end);
+	return end != text && *end == '\0' && value >= 0.0 && value <= 1.0;
+}
+
+// Streams 'lines' lines from 'generator' to 'out' a block at a time.
+template <typename Generator>
+static bool Write(Generator &generator, std::size_t lines, std::FILE *out)
+{
+	constexpr std::size_t kBlockLines = 1 << 16;
+	std::string block;
+	while (lines > 0)
+	{
+		std::size_t n = lines < kBlockLines ? lines : kBlockLines;
+		block.clear();
+		generator.Append(block, n);
+		if (std::fwrite(block.data(), 1, block.size(), out) != block.size())
+		{
+			return false;
+		}
+		lines -= n;
+	}
+	return std::fflush(out) == 0;
+}
+
+int main(int argc, char **argv)
+{
+	std::string_view day = argc > 1 ? argv[1] : "";
+	std::size_t lines = 0;
+	uint64_t seed = 1;
+	std::string outPath;
+	synthetic::Day1Spec day1;
+	synthetic::Day2Spec day2;
+
+	bool ok = day == "day1" || day == "day2";
+	for (int i = 2; ok && i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			ok = false;
+			break;
+		}
+		const char *value = argv[++i];
+		if (arg == "--lines")
+		{
+			ok = ParseNumber(value, lines);
+		}
+		else if (arg == "--seed")
+		{
+			ok = ParseNumber(value, seed);
+		}
+		else if (arg == "--out")
+		{
+			outPath = value;
+		}
+		else if (day == "day1" && arg == "--min")
+		{
+			ok = ParseNumber(value, day1.minValue) && day1.minValue >= 0;
+		}
+		else if (day == "day1" && arg == "--max")
+		{
+			ok = ParseNumber(value, day1.maxValue);
+		}
+		else if (day == "day1" && arg == "--duplicates")
+		{
+			ok = ParseFraction(value, day1.duplicateRate);
+		}
+		else if (day == "day2" && arg == "--min-length")
+		{
+			ok = ParseNumber(value, day2.minLength);
+		}
+		else if (day == "day2" && arg == "--max-length")
+		{
+			ok = ParseNumber(value, day2.maxLength);
+		}
+		else if (day == "day2" && arg == "--safe")
+		{
+			ok = ParseFraction(value, day2.safeFraction);
+		}
+		else if (day == "day2" && arg == "--fixable")
+		{
+			ok = ParseFraction(value, day2.fixableFraction);
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+	ok = ok && day1.minValue <= day1.maxValue &&
+		 day2.safeFraction + day2.fixableFraction <= 1.0;
+	if (!ok)
+	{
+		std::cerr << "Usage: " << argv[0]
+				  << " day1 --lines n [--min v] [--max v] [--duplicates rate]"
+					 " [--seed s] [--out path]\n"
+				  << "       " << argv[0]
+				  << " day2 --lines n [--min-length n] [--max-length n]"
+					 " [--safe fraction] [--fixable fraction] [--seed s]"
+					 " [--out path]"
+				  << std::endl;
+		return 1;
+	}
+
+	std::FILE *out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "wb");
+	if (!out)
+	{
+		std::cerr << "ERROR: Unable to open file at path: " << outPath
+				  << std::endl;
+		return 1;
+	}
+	bool written;
+	if (day == "day1")
+	{
+		synthetic::Day1Generator generator(day1, seed);
+		written = Write(generator, lines, out);
+	}
+	else
+	{
+		synthetic::Day2Generator generator(day2, seed);
+		written = Write(generator, lines, out);
+	}
+	if (out != stdout)
+	{
+		written = std::fclose(out) == 0 && written;
+	}
+	if (!written)
+	{
+		std::cerr << "ERROR: Write failed" << std::endl;
+		return 1;
+	}
+	return 0;
+}
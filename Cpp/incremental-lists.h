@@ -0,0 +1,355 @@
+#ifndef AOC_INCREMENTAL_LISTS_H
+#define AOC_INCREMENTAL_LISTS_H
+
+#include <algorithm>	 // For std::sort, std::lower_bound, std::upper_bound
+#include <cmath>		 // For std::sqrt (block size)
+#include <cstddef>		 // For std::size_t
+#include <cstdint>		 // For int8_t, int32_t, int64_t
+#include <cstdlib>		 // For std::llabs
+#include <unordered_map> // For std::unordered_map (per-value counts)
+#include <utility>		 // For std::pair
+#include <vector>		 // For std::vector
+
+/**
+ * @brief Day 1's two lists under a stream of pair inserts and removals, with
+ * the total distance and the similarity score kept current after every update.
+ *
+ * Similarity is sum(v * countLeft(v) * countRight(v)), so an update changes it
+ * by one product read from two count maps: O(1) expected.
+ *
+ * Distance uses the fact that for two sorted lists of equal length,
+ * sum |a_i - b_i| equals the integral over t of |#{a <= t} - #{b <= t}|. All
+ * values are kept in one sorted sequence of events (+1 for the left list, -1
+ * for the right), cut into blocks of about B = sqrt(2n) events (at least
+ * kMinBlockSize). Each block tabulates its share of the integral as a
+ * function of the running count entering it, so an update only rebuilds its
+ * own block, in O(B). The blocks are re-summed with one table lookup each,
+ * in O(n / B), and only when Distance() is read after updates. A batch of k
+ * updates followed by one read therefore costs O(k * B + n / B), which is
+ * O(k * sqrt(n)) rather than a re-sort of both lists.
+ */
+class IncrementalLists
+{
+public:
+	static constexpr std::size_t kMinBlockSize = 64;
+
+	IncrementalLists() = default;
+
+	// Builds the structure from two columns of equal length in O(n log n).
+	IncrementalLists(const std::vector<int32_t> &left,
+					 const std::vector<int32_t> &right)
+	{
+		std::vector<std::pair<int32_t, int8_t>> events;
+		std::size_t n = std::min(left.size(), right.size());
+		events.reserve(2 * n);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			events.push_back({left[i], 1});
+			events.push_back({right[i], -1});
+			AddCounts(left[i], right[i], 1);
+		}
+		std::sort(events.begin(), events.end());
+		pairs = n;
+		Chunk(events);
+	}
+
+	// Adds one (left, right) pair.
+	void Insert(int32_t left, int32_t right)
+	{
+		InsertEvent(left, 1);
+		InsertEvent(right, -1);
+		AddCounts(left, right, 1);
+		pairs++;
+		dirty = true;
+	}
+
+	/**
+	 * @brief Removes one occurrence of 'left' from the left list and of 'right'
+	 * from the right list.
+	 * @return false (and changes nothing) if either value is not present.
+	 */
+	bool Remove(int32_t left, int32_t right)
+	{
+		if (CountOf(countsLeft, left) == 0 || CountOf(countsRight, right) == 0)
+		{
+			return false;
+		}
+		EraseEvent(left, 1);
+		EraseEvent(right, -1);
+		AddCounts(left, right, -1);
+		pairs--;
+		// After many removals the blocks run far below the (shrinking)
+		// target size; re-cut them so the re-sum stays O(n / B)
+		if (blocks.size() > 4 * (2 * pairs / BlockSize() + 1))
+		{
+			Rechunk();
+		}
+		dirty = true;
+		return true;
+	}
+
+	// Re-sums the blocks first if an update came in since the last call.
+	int64_t Distance() const
+	{
+		if (dirty)
+		{
+			Resum();
+		}
+		return distance;
+	}
+	int64_t Similarity() const { return similarity; }
+	std::size_t Size() const { return pairs; }
+
+private:
+	// A sorted run of events. For a running count o entering the block, its
+	// internal gaps contribute Cost(o) = sum |o + p_j| * (v_{j+1} - v_j),
+	// where p_j is the block-local prefix of signs up to element j.
+	struct Block
+	{
+		std::vector<int32_t> values;
+		std::vector<int8_t> signs;
+		int64_t net = 0;	// Sum of signs
+		int64_t weight = 0; // Sum of internal gaps
+		int64_t moment = 0; // Sum of p_j * gap_j
+		// Cost(o) for o in [first, first + table.size()); outside that range
+		// every |o + p_j| has one sign and Cost is linear.
+		int64_t first = 0;
+		std::vector<int64_t> table;
+
+		int64_t Cost(int64_t o) const
+		{
+			if (o < first)
+			{
+				return -(o * weight + moment);
+			}
+			if (o - first >= static_cast<int64_t>(table.size()))
+			{
+				return o * weight + moment;
+			}
+			return table[o - first];
+		}
+
+		void Rebuild()
+		{
+			net = 0;
+			weight = 0;
+			moment = 0;
+			table.clear();
+			if (values.empty())
+			{
+				return;
+			}
+			// Gap weight per local prefix value, over [pmin, pmax]
+			int64_t p = 0, pmin = 0, pmax = 0;
+			std::vector<std::pair<int64_t, int64_t>> steps;
+			steps.reserve(values.size());
+			for (std::size_t j = 0; j + 1 < values.size(); j++)
+			{
+				p += signs[j];
+				int64_t gap = int64_t(values[j + 1]) - int64_t(values[j]);
+				steps.push_back({p, gap});
+				pmin = std::min(pmin, p);
+				pmax = std::max(pmax, p);
+			}
+			net = p + signs.back();
+			std::vector<int64_t> byPrefix(pmax - pmin + 1, 0);
+			for (const auto &[prefix, gap] : steps)
+			{
+				byPrefix[prefix - pmin] += gap;
+				weight += gap;
+				moment += prefix * gap;
+			}
+			// Walk o from -pmax to -pmin: each step up adds the weight already
+			// at or above zero and subtracts the weight still below it.
+			first = -pmax;
+			table.resize(byPrefix.size());
+			int64_t cost = pmax * weight - moment;
+			int64_t atOrAbove = 0;
+			for (std::size_t k = 0; k < table.size(); k++)
+			{
+				atOrAbove += byPrefix[byPrefix.size() - 1 - k];
+				table[k] = cost;
+				cost += 2 * atOrAbove - weight;
+			}
+		}
+	};
+
+	std::vector<Block> blocks;
+	std::unordered_map<int32_t, int64_t> countsLeft;
+	std::unordered_map<int32_t, int64_t> countsRight;
+	std::size_t pairs = 0;
+	// Distance() is computed on demand; updates only mark it stale
+	mutable int64_t distance = 0;
+	mutable bool dirty = false;
+	int64_t similarity = 0;
+
+	// Target events per block for the current size: about sqrt(2n)
+	std::size_t BlockSize() const
+	{
+		std::size_t root = static_cast<std::size_t>(
+			std::sqrt(static_cast<double>(2 * pairs)));
+		return std::max(root, kMinBlockSize);
+	}
+
+	// Replaces the blocks with 'events' (sorted) cut into BlockSize() runs.
+	void Chunk(const std::vector<std::pair<int32_t, int8_t>> &events)
+	{
+		blocks.clear();
+		const std::size_t size = BlockSize();
+		for (std::size_t i = 0; i < events.size(); i += size)
+		{
+			Block &block = blocks.emplace_back();
+			std::size_t end = std::min(events.size(), i + size);
+			for (std::size_t j = i; j < end; j++)
+			{
+				block.values.push_back(events[j].first);
+				block.signs.push_back(events[j].second);
+			}
+			block.Rebuild();
+		}
+		dirty = true;
+	}
+
+	// Re-cuts the current events at the current target size, in O(n).
+	void Rechunk()
+	{
+		std::vector<std::pair<int32_t, int8_t>> events;
+		events.reserve(2 * pairs);
+		for (const Block &block : blocks)
+		{
+			for (std::size_t j = 0; j < block.values.size(); j++)
+			{
+				events.push_back({block.values[j], block.signs[j]});
+			}
+		}
+		Chunk(events);
+	}
+
+	static int64_t CountOf(const std::unordered_map<int32_t, int64_t> &counts,
+						   int32_t value)
+	{
+		auto it = counts.find(value);
+		return it == counts.end() ? 0 : it->second;
+	}
+
+	// Updates the count maps and the similarity for one pair added
+	// (delta = 1) or removed (delta = -1). The left value is applied first on
+	// insert and last on removal, so left == right is handled exactly.
+	void AddCounts(int32_t left, int32_t right, int delta)
+	{
+		if (delta > 0)
+		{
+			similarity += int64_t(left) * CountOf(countsRight, left);
+			countsLeft[left]++;
+			similarity += int64_t(right) * CountOf(countsLeft, right);
+			countsRight[right]++;
+			return;
+		}
+		if (--countsRight[right] == 0)
+		{
+			countsRight.erase(right);
+		}
+		similarity -= int64_t(right) * CountOf(countsLeft, right);
+		if (--countsLeft[left] == 0)
+		{
+			countsLeft.erase(left);
+		}
+		similarity -= int64_t(left) * CountOf(countsRight, left);
+	}
+
+	// Index of the first block whose last value is >= 'value' (or the last
+	// block if there is none).
+	std::size_t BlockFor(int32_t value) const
+	{
+		auto it = std::lower_bound(blocks.begin(), blocks.end(), value,
+								   [](const Block &block, int32_t v)
+								   { return block.values.back() < v; });
+		std::size_t b = static_cast<std::size_t>(it - blocks.begin());
+		return b == blocks.size() ? b - 1 : b;
+	}
+
+	void InsertEvent(int32_t value, int8_t sign)
+	{
+		if (blocks.empty())
+		{
+			blocks.emplace_back();
+		}
+		std::size_t b = blocks[0].values.empty() ? 0 : BlockFor(value);
+		Block &block = blocks[b];
+		std::size_t at = static_cast<std::size_t>(
+			std::upper_bound(block.values.begin(), block.values.end(), value) -
+			block.values.begin());
+		block.values.insert(block.values.begin() + at, value);
+		block.signs.insert(block.signs.begin() + at, sign);
+		if (block.values.size() >= 2 * BlockSize())
+		{
+			// Split in half so blocks stay near the target, which grows with n
+			const std::size_t half = block.values.size() / 2;
+			Block upper;
+			upper.values.assign(block.values.begin() + half,
+								block.values.end());
+			upper.signs.assign(block.signs.begin() + half, block.signs.end());
+			block.values.resize(half);
+			block.signs.resize(half);
+			block.Rebuild();
+			upper.Rebuild();
+			blocks.insert(blocks.begin() + b + 1, std::move(upper));
+			return;
+		}
+		block.Rebuild();
+	}
+
+	// Removes one event with this value and sign; the caller has checked via
+	// the count maps that it exists. Equal values may span several blocks.
+	void EraseEvent(int32_t value, int8_t sign)
+	{
+		for (std::size_t b = BlockFor(value); b < blocks.size(); b++)
+		{
+			Block &block = blocks[b];
+			std::size_t at = static_cast<std::size_t>(
+				std::lower_bound(block.values.begin(), block.values.end(),
+								 value) -
+				block.values.begin());
+			for (; at < block.values.size() && block.values[at] == value; at++)
+			{
+				if (block.signs[at] == sign)
+				{
+					block.values.erase(block.values.begin() + at);
+					block.signs.erase(block.signs.begin() + at);
+					if (block.values.empty())
+					{
+						blocks.erase(blocks.begin() + b);
+					}
+					else
+					{
+						block.Rebuild();
+					}
+					return;
+				}
+			}
+		}
+	}
+
+	// Sums every block's cost plus the gap between neighbouring blocks.
+	void Resum() const
+	{
+		int64_t total = 0;
+		int64_t running = 0;
+		for (std::size_t b = 0; b < blocks.size(); b++)
+		{
+			const Block &block = blocks[b];
+			total += block.Cost(running);
+			running += block.net;
+			if (b + 1 < blocks.size())
+			{
+				total += std::llabs(running) *
+						 (int64_t(blocks[b + 1].values.front()) -
+						  int64_t(block.values.back()));
+			}
+		}
+		distance = total;
+		dirty = false;
+	}
+};
+
+#endif // AOC_INCREMENTAL_LISTS_H
@@ -0,0 +1,102 @@
+#ifndef AOC_INPUT_SET_H
+#define AOC_INPUT_SET_H
+
+#include <cstddef>  // For std::size_t
+#include <fstream>	// For std::ifstream
+#include <iostream> // For std::cerr
+#include <string>	// For std::string, std::getline
+#include <vector>	// For std::vector
+
+#if __has_include(<glob.h>)
+#include <glob.h> // For glob, globfree
+#define AOC_HAVE_GLOB 1
+#else
+#define AOC_HAVE_GLOB 0
+#endif
+
+/**
+ * Turns the --input arguments into a list of files. Each argument is one of
+ *   path        a single file, taken as is (a missing file fails at load)
+ *   pattern     a glob such as "shards/day1-*.txt", expanded in sorted order
+ *               without a shell, so argv limits never apply
+ *   @listfile   a file naming one path or pattern per line
+ */
+
+namespace input_set_detail
+{
+inline bool IsPattern(const std::string &text)
+{
+	return text.find_first_of("*?[") != std::string::npos;
+}
+
+inline bool ExpandOne(const std::string &input, std::vector<std::string> &paths,
+					  int depth)
+{
+	if (!input.empty() && input[0] == '@' && depth == 0)
+	{
+		std::ifstream list(input.substr(1));
+		if (!list)
+		{
+			std::cerr << "ERROR: Unable to open input list: " << input.substr(1)
+					  << std::endl;
+			return false;
+		}
+		std::string line;
+		while (std::getline(list, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.pop_back();
+			}
+			if (!line.empty() && !ExpandOne(line, paths, depth + 1))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+#if AOC_HAVE_GLOB
+	if (IsPattern(input))
+	{
+		glob_t matches{};
+		int status = glob(input.c_str(), 0, nullptr, &matches);
+		if (status == 0)
+		{
+			for (std::size_t i = 0; i < matches.gl_pathc; i++)
+			{
+				paths.emplace_back(matches.gl_pathv[i]);
+			}
+		}
+		globfree(&matches);
+		if (status != 0)
+		{
+			std::cerr << "ERROR: No input matches: " << input << std::endl;
+			return false;
+		}
+		return true;
+	}
+#endif
+	paths.push_back(input);
+	return true;
+}
+} // namespace input_set_detail
+
+/**
+ * @brief Appends the files named by 'inputs' to 'paths', in argument order.
+ * @return false, after reporting on std::cerr, if a pattern matches nothing
+ * or a list file can't be read.
+ */
+inline bool ExpandInputs(const std::vector<std::string> &inputs,
+						 std::vector<std::string> &paths)
+{
+	for (const std::string &input : inputs)
+	{
+		if (!input_set_detail::ExpandOne(input, paths, 0))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#endif // AOC_INPUT_SET_H
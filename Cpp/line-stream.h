@@ -0,0 +1,197 @@
+#ifndef AOC_LINE_STREAM_H
+#define AOC_LINE_STREAM_H
+
+#include <cstddef>	   // For std::size_t
+#include <cstdio>	   // For std::FILE, std::fread, std::ferror
+#include <cstring>	   // For std::memchr, std::memmove
+#include <string_view> // For std::string_view
+#include <vector>	   // For std::vector
+
+#include "profile.h" // For AOC_PROFILE_SCOPE, AOC_PROFILE_COUNT
+
+/**
+ * @brief Anything that can fill a buffer with the next bytes of an input:
+ * a file, a pipe, stdin, or a decompressor (compressed-input.h). Sources are pulled, so
+ * they never hold more than the caller's buffer.
+ */
+class ByteSource
+{
+public:
+	virtual ~ByteSource() = default;
+
+	/**
+	 * @brief Reads up to 'capacity' bytes into 'dst'.
+	 * @return The number of bytes read; 0 at end of input or on error.
+	 */
+	virtual std::size_t Read(char *dst, std::size_t capacity) = 0;
+
+	// True if the source stopped because of an error rather than at EOF.
+	virtual bool Failed() const = 0;
+};
+
+/**
+ * @brief ByteSource over a C stdio stream. Works for regular files, pipes and
+ * stdin alike; the stream is not closed on destruction.
+ */
+class StdioSource : public ByteSource
+{
+public:
+	explicit StdioSource(std::FILE *file) : file(file) {}
+
+	std::size_t Read(char *dst, std::size_t capacity) override
+	{
+		return std::fread(dst, 1, capacity, file);
+	}
+
+	bool Failed() const override { return std::ferror(file) != 0; }
+
+private:
+	std::FILE *file;
+};
+
+/**
+ * @brief Splits a ByteSource into lines using one fixed-size chunk buffer.
+ * Lines are std::string_view spans into the buffer, valid until the next call
+ * to NextLine. When the buffer runs out, the unfinished tail is moved to the
+ * front and the rest is refilled, so memory stays at one chunk no matter how
+ * long the input is (a line longer than the chunk grows the buffer to fit).
+ */
+class LineStream
+{
+public:
+	explicit LineStream(ByteSource &source,
+						std::size_t chunkBytes = std::size_t(1) << 20)
+		: source(source), buffer(chunkBytes > 0 ? chunkBytes : 1)
+	{
+	}
+
+	/**
+	 * @brief Returns the next line, without its '\n' (or trailing '\r').
+	 * @return false at end of input.
+	 */
+	bool NextLine(std::string_view &line)
+	{
+		for (;;)
+		{
+			const char *begin = buffer.data() + pos;
+			const void *nl = std::memchr(begin, '\n', end - pos);
+			if (nl)
+			{
+				std::size_t length = static_cast<std::size_t>(
+					static_cast<const char *>(nl) - begin);
+				pos += length + 1;
+				line = Trim(std::string_view(begin, length));
+				return true;
+			}
+			if (eof)
+			{
+				if (pos == end)
+				{
+					return false;
+				}
+				// Final line without a trailing newline
+				line = Trim(std::string_view(begin, end - pos));
+				pos = end;
+				return true;
+			}
+			Refill();
+		}
+	}
+
+	// Bytes pulled from the source so far.
+	std::size_t BytesRead() const { return bytesRead; }
+
+	bool Failed() const { return source.Failed(); }
+
+private:
+	ByteSource &source;
+	std::vector<char> buffer;
+	std::size_t pos = 0; // Start of unread data
+	std::size_t end = 0; // End of valid data
+	std::size_t bytesRead = 0;
+	bool eof = false;
+
+	static std::string_view Trim(std::string_view line)
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	void Refill()
+	{
+		AOC_PROFILE_SCOPE(Read);
+		// Keep the partial line, then fill the space after it.
+		std::size_t tail = end - pos;
+		if (pos > 0)
+		{
+			std::memmove(buffer.data(), buffer.data() + pos, tail);
+		}
+		pos = 0;
+		end = tail;
+		if (end == buffer.size())
+		{
+			buffer.resize(buffer.size() * 2);
+		}
+		std::size_t got = source.Read(buffer.data() + end, buffer.size() - end);
+		if (got == 0)
+		{
+			eof = true;
+		}
+		end += got;
+		bytesRead += got;
+		AOC_PROFILE_COUNT(BytesRead, got);
+	}
+};
+
+/**
+ * @brief Calls fn(std::string_view text) with the bytes of 'source' cut at
+ * line boundaries, reading up to 'blockBytes' at a time into one buffer: every
+ * text passed holds whole lines only (the last one may lack its '\n' at end of
+ * input). The unfinished tail of each block is moved to the front before the
+ * next read; a line longer than the block grows the buffer to fit.
+ * @return false if the source failed part-way through.
+ */
+template <typename Fn>
+bool ForEachLineBlock(ByteSource &source, std::size_t blockBytes, Fn &&fn)
+{
+	std::vector<char> buffer(blockBytes > 0 ? blockBytes : 1);
+	std::size_t end = 0; // Valid bytes in 'buffer'
+	for (;;)
+	{
+		if (end == buffer.size())
+		{
+			buffer.resize(buffer.size() * 2);
+		}
+		std::size_t got;
+		{
+			AOC_PROFILE_SCOPE(Read);
+			got = source.Read(buffer.data() + end, buffer.size() - end);
+		}
+		AOC_PROFILE_COUNT(BytesRead, got);
+		if (got == 0)
+		{
+			break;
+		}
+		end += got;
+		std::string_view text(buffer.data(), end);
+		std::size_t last = text.rfind('\n');
+		if (last == std::string_view::npos)
+		{
+			continue;
+		}
+		fn(text.substr(0, last + 1));
+		std::size_t tail = end - (last + 1);
+		std::memmove(buffer.data(), buffer.data() + last + 1, tail);
+		end = tail;
+	}
+	if (end > 0)
+	{
+		fn(std::string_view(buffer.data(), end));
+	}
+	return !source.Failed();
+}
+
+#endif // AOC_LINE_STREAM_H
@@ -0,0 +1,322 @@
+#ifndef AOC_MAPPED_FILE_H
+#define AOC_MAPPED_FILE_H
+
+#include <cerrno>	   // For errno, EINTR
+#include <cstddef>	   // For std::size_t
+#include <cstring>	   // For std::memchr (fast newline search)
+#include <fstream>	   // For std::ifstream (buffered fallback)
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view (non-owning line spans)
+#include <utility>	   // For std::exchange
+#include <vector>	   // For std::vector
+
+#include "profile.h" // For AOC_PROFILE_SCOPE, AOC_PROFILE_COUNT
+
+// mmap is only available on POSIX hosts. Everywhere else the loader falls back
+// to reading the whole file into one buffer, which still gives callers a single
+// contiguous view to slice lines out of.
+#if defined(__unix__) || defined(__APPLE__)
+#define AOC_HAVE_MMAP 1
+#include <fcntl.h>	  // For open
+#include <sys/mman.h> // For mmap, munmap, madvise
+#include <sys/stat.h> // For fstat
+#include <unistd.h>	  // For close, read
+#else
+#define AOC_HAVE_MMAP 0
+#endif
+
+/**
+ * @brief Read-only view of a whole input file.
+ * The file is memory-mapped when the platform supports it, so the text is
+ * never copied: every std::string_view handed out points straight into the
+ * page cache. If mapping fails (or is unavailable) the file is read once into
+ * an internal buffer instead. Either way View() covers the entire file.
+ */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string &path) { Open(path); }
+	~MappedFile() { Close(); }
+
+	// Owning a mapping makes copies meaningless; moves transfer ownership.
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+	MappedFile &operator=(MappedFile &&other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+			mapped = std::exchange(other.mapped, false);
+			isOpen = std::exchange(other.isOpen, false);
+			buffer = std::move(other.buffer);
+			// A moved std::string may have been stored in-place (SSO), so the
+			// pointer has to be re-derived from our own copy.
+			if (!mapped && isOpen)
+			{
+				data = buffer.data();
+			}
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Opens and maps the file at 'path', releasing any previous file.
+	 * @param path The file path.
+	 * @return true if the file could be opened (an empty file is a success).
+	 */
+	bool Open(const std::string &path)
+	{
+		AOC_PROFILE_SCOPE(Open);
+		Close();
+#if AOC_HAVE_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat st;
+		const bool stated = ::fstat(fd, &st) == 0;
+		if (stated && !S_ISREG(st.st_mode))
+		{
+			// A pipe, FIFO, terminal or process substitution: st_size says
+			// nothing about its contents, so read the descriptor to its end.
+			bool ok = ReadDescriptor(fd);
+			::close(fd);
+			return ok;
+		}
+		if (stated)
+		{
+			size = static_cast<std::size_t>(st.st_size);
+			if (size == 0)
+			{
+				// mmap rejects zero-length mappings; an empty view is fine.
+				::close(fd);
+				isOpen = true;
+				return true;
+			}
+			void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED)
+			{
+				// The solvers scan front to back exactly once, so ask the
+				// kernel for aggressive read-ahead.
+				::madvise(p, size, MADV_SEQUENTIAL);
+				::close(fd);
+				data = static_cast<const char *>(p);
+				AOC_PROFILE_COUNT(BytesRead, size);
+				mapped = true;
+				isOpen = true;
+				return true;
+			}
+		}
+		// fstat or mmap failed: fall through to the buffered reader below.
+		::close(fd);
+		size = 0;
+#endif
+		return ReadBuffered(path);
+	}
+
+	/**
+	 * @brief Unmaps (or frees) the current file, leaving an empty view.
+	 */
+	void Close()
+	{
+#if AOC_HAVE_MMAP
+		if (mapped)
+		{
+			::munmap(const_cast<char *>(data), size);
+		}
+#endif
+		data = nullptr;
+		size = 0;
+		mapped = false;
+		isOpen = false;
+		buffer.clear();
+		buffer.shrink_to_fit();
+	}
+
+	// Accessors. View() is valid for as long as this object is alive.
+	std::string_view View() const { return {data, size}; }
+	std::size_t Size() const { return size; }
+	bool IsOpen() const { return isOpen; }
+	bool IsMapped() const { return mapped; }
+
+private:
+	const char *data = nullptr;
+	std::size_t size = 0;
+	bool mapped = false;
+	bool isOpen = false;
+	// Only used by the buffered fallback.
+	std::string buffer;
+
+#if AOC_HAVE_MMAP
+	// Reads 'fd' until end of file into 'buffer', for inputs with no size.
+	bool ReadDescriptor(int fd)
+	{
+		AOC_PROFILE_SCOPE(Read);
+		constexpr std::size_t kChunk = 1 << 16;
+		std::size_t used = 0;
+		for (;;)
+		{
+			buffer.resize(used + kChunk);
+			ssize_t n = ::read(fd, &buffer[used], kChunk);
+			if (n < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				buffer.clear();
+				return false;
+			}
+			if (n == 0)
+			{
+				break;
+			}
+			used += static_cast<std::size_t>(n);
+		}
+		buffer.resize(used);
+		AOC_PROFILE_COUNT(BytesRead, used);
+		data = buffer.data();
+		size = buffer.size();
+		isOpen = true;
+		return true;
+	}
+#endif
+
+	// Fallback: one large read into 'buffer' (no per-line std::string copies).
+	bool ReadBuffered(const std::string &path)
+	{
+		AOC_PROFILE_SCOPE(Read);
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open())
+		{
+			return false;
+		}
+		in.seekg(0, std::ios::end);
+		std::streamoff length = in.tellg();
+		in.seekg(0, std::ios::beg);
+		if (length > 0)
+		{
+			buffer.resize(static_cast<std::size_t>(length));
+			in.read(&buffer[0], length);
+			buffer.resize(static_cast<std::size_t>(in.gcount()));
+			AOC_PROFILE_COUNT(BytesRead, buffer.size());
+		}
+		data = buffer.data();
+		size = buffer.size();
+		isOpen = true;
+		return true;
+	}
+};
+
+/**
+ * @brief Splits the next line off the front of 'rest'.
+ * The returned line excludes the '\n' (and a trailing '\r' for CRLF files).
+ * @param rest The unread remainder of the buffer; advanced past the line.
+ * @param line Receives the line span.
+ * @return false once 'rest' is exhausted.
+ */
+inline bool NextLine(std::string_view &rest, std::string_view &line)
+{
+	if (rest.empty())
+	{
+		return false;
+	}
+	const char *begin = rest.data();
+	const void *nl = std::memchr(begin, '\n', rest.size());
+	std::size_t length =
+		nl ? static_cast<std::size_t>(static_cast<const char *>(nl) - begin)
+		   : rest.size();
+	line = rest.substr(0, length);
+	rest.remove_prefix(nl ? length + 1 : length);
+	if (!line.empty() && line.back() == '\r')
+	{
+		line.remove_suffix(1);
+	}
+	return true;
+}
+
+/**
+ * @brief Calls fn(std::string_view line) for every line in 'buffer'.
+ * Empty lines are passed through; callers decide whether to skip them.
+ */
+template <typename Fn>
+void ForEachLine(std::string_view buffer, Fn &&fn)
+{
+	std::string_view line;
+	while (NextLine(buffer, line))
+	{
+		fn(line);
+	}
+}
+
+/**
+ * @brief Cuts 'buffer' into at most 'parts' spans of roughly equal size for
+ * parallel parsing. Every cut is placed just after a '\n', so no line
+ * straddles two spans and parsing the spans in order sees exactly the lines
+ * of the whole buffer. Spans are never smaller than 'minBytes' (except the
+ * last), so small inputs stay in one piece.
+ */
+inline std::vector<std::string_view>
+SplitAtLineBoundaries(std::string_view buffer, std::size_t parts,
+					  std::size_t minBytes = std::size_t(1) << 20)
+{
+	std::vector<std::string_view> spans;
+	if (parts == 0)
+	{
+		parts = 1;
+	}
+	std::size_t target = buffer.size() / parts;
+	if (target < minBytes)
+	{
+		target = minBytes;
+	}
+	while (!buffer.empty())
+	{
+		std::size_t cut = buffer.size();
+		if (target < buffer.size())
+		{
+			std::size_t nl = buffer.find('\n', target);
+			cut = nl == std::string_view::npos ? buffer.size() : nl + 1;
+		}
+		spans.push_back(buffer.substr(0, cut));
+		buffer.remove_prefix(cut);
+	}
+	return spans;
+}
+
+/**
+ * @brief Estimates how many lines 'totalBytes' of text hold from the average
+ * line length in 'sample' (its first 64 KB of whole lines), plus 1% and a
+ * few lines of slack so that reserving the estimate rarely leaves a vector
+ * one reallocation short. Returns 0 when the sample has no complete line.
+ */
+inline std::size_t EstimateLineCount(std::string_view sample,
+									 std::size_t totalBytes)
+{
+	constexpr std::size_t kSampleBytes = std::size_t(1) << 16;
+	if (sample.size() > kSampleBytes)
+	{
+		sample = sample.substr(0, kSampleBytes);
+	}
+	std::size_t last = sample.rfind('\n');
+	if (last == std::string_view::npos)
+	{
+		return 0;
+	}
+	std::size_t lines = 0;
+	for (std::size_t i = 0; i <= last; i++)
+	{
+		lines += sample[i] == '\n';
+	}
+	std::size_t estimate = static_cast<std::size_t>(
+		static_cast<double>(totalBytes) * static_cast<double>(lines) /
+		static_cast<double>(last + 1));
+	return estimate + estimate / 100 + 16;
+}
+
+#endif // AOC_MAPPED_FILE_H
@@ -0,0 +1,449 @@
+#ifndef AOC_PACKED_COLUMN_H
+#define AOC_PACKED_COLUMN_H
+
+#include <algorithm> // For std::min, std::max, std::minmax_element
+#include <cstddef>	 // For std::size_t
+#include <cstdint>	 // For int32_t, uint32_t, uint64_t, int64_t
+#include <utility>	 // For std::swap
+#include <vector>	 // For std::vector
+
+#include "distance-kernel.h" // For ColumnDistance
+#include "thread-pool.h"	 // For WorkStealingPool
+
+/**
+ * Day 1's compact column layout. Each value is stored as (value - bias) in
+ * the fewest bits that hold the column's range, back to back in 64-bit
+ * words: 5-digit IDs take 17 bits instead of 32, so both lists of a large
+ * input need about half the memory. The sort and count kernels below work on
+ * the packed words directly and never expand a whole column.
+ */
+
+/**
+ * @brief A column of int32_t values bit-packed at a common width. The width
+ * and bias widen as values arrive (Append repacks the column when a value
+ * falls outside the current range), so the caller needn't know the range up
+ * front. One spare word past the end lets every read and write touch two
+ * words without a bounds check.
+ */
+class PackedColumn
+{
+public:
+	std::size_t Size() const { return size; }
+	bool Empty() const { return size == 0; }
+	unsigned Bits() const { return bits; }
+	int32_t Bias() const { return bias; }
+	// Heap bytes held by the packed words.
+	std::size_t Bytes() const { return words.capacity() * sizeof(uint64_t); }
+
+	void Clear()
+	{
+		words.clear();
+		size = 0;
+		bits = 0;
+		bias = 0;
+		reserved = 0;
+	}
+
+	// Makes room for 'rows' values in total; applied again on every repack.
+	void Reserve(std::size_t rows)
+	{
+		reserved = std::max(reserved, rows);
+		if (bits > 0)
+		{
+			words.reserve(WordsFor(reserved, bits));
+		}
+	}
+
+	// Appends n values, widening the column first if they don't fit.
+	void Append(const int32_t *values, std::size_t n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+		auto [lo, hi] = std::minmax_element(values, values + n);
+		// Non-negative columns keep a zero bias, so the width follows the
+		// largest value and doesn't change with early blocks' minimums.
+		int64_t low = std::min<int64_t>(*lo, 0);
+		int64_t high = *hi;
+		if (size > 0)
+		{
+			// The current range's top, capped at what an int32_t can hold
+			int64_t top = std::min<int64_t>(int64_t(bias) + int64_t(Mask()),
+											INT32_MAX);
+			low = std::min<int64_t>(low, bias);
+			high = std::max<int64_t>(high, top);
+		}
+		unsigned need = BitsFor(static_cast<uint64_t>(high - low));
+		if (size == 0 || need != bits || low != bias)
+		{
+			Repack(static_cast<int32_t>(low), need);
+		}
+		words.resize(WordsFor(size + n, bits), 0);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			Put(size + i, static_cast<uint32_t>(int64_t(values[i]) - bias));
+		}
+		size += n;
+	}
+
+	// Biased key of value i, in [0, 2^bits).
+	uint32_t Key(std::size_t i) const
+	{
+		uint64_t pos = uint64_t(i) * bits;
+		std::size_t w = static_cast<std::size_t>(pos >> 6);
+		unsigned off = static_cast<unsigned>(pos & 63);
+		// The two-step shift is 0 when off is 0 (a shift by 64 is undefined)
+		uint64_t v = (words[w] >> off) | ((words[w + 1] << 1) << (63 - off));
+		return static_cast<uint32_t>(v & Mask());
+	}
+
+	int32_t Get(std::size_t i) const
+	{
+		return static_cast<int32_t>(int64_t(Key(i)) + bias);
+	}
+
+	// Copies values [begin, begin + n) to 'out'.
+	void Unpack(std::size_t begin, std::size_t n, int32_t *out) const
+	{
+		for (std::size_t i = 0; i < n; i++)
+		{
+			out[i] = Get(begin + i);
+		}
+	}
+
+	// Clears every key to 0, ready for Put to rewrite the column in place.
+	void ZeroKeys() { std::fill(words.begin(), words.end(), 0); }
+
+	// Writes key at index i into zeroed space. Any 64 consecutive values
+	// start and end on word boundaries, and the next word is only touched
+	// when the value spills into it, so writers of disjoint 64-aligned
+	// index ranges never share a word.
+	void Put(std::size_t i, uint32_t key)
+	{
+		uint64_t pos = uint64_t(i) * bits;
+		std::size_t w = static_cast<std::size_t>(pos >> 6);
+		unsigned off = static_cast<unsigned>(pos & 63);
+		words[w] |= uint64_t(key) << off;
+		if (off + bits > 64)
+		{
+			words[w + 1] |= uint64_t(key) >> (64 - off);
+		}
+	}
+
+	// Zeroed storage of the same width for 'rows' values (sort scratch).
+	PackedColumn SameShape(std::size_t rows) const
+	{
+		PackedColumn other;
+		other.bits = bits;
+		other.bias = bias;
+		other.size = rows;
+		other.words.assign(WordsFor(rows, bits), 0);
+		return other;
+	}
+
+	void Swap(PackedColumn &other)
+	{
+		words.swap(other.words);
+		std::swap(size, other.size);
+		std::swap(bits, other.bits);
+		std::swap(bias, other.bias);
+		std::swap(reserved, other.reserved);
+	}
+
+	static unsigned BitsFor(uint64_t range)
+	{
+		return range == 0 ? 0 : 64 - __builtin_clzll(range);
+	}
+
+private:
+	std::vector<uint64_t> words;
+	std::size_t size = 0;
+	unsigned bits = 0;
+	int32_t bias = 0;
+	std::size_t reserved = 0;
+
+	uint64_t Mask() const { return (uint64_t(1) << bits) - 1; }
+
+	// Words for 'rows' values plus the spare one. A zero-width column (every
+	// value equal to the bias) still needs words[0] and the spare.
+	static std::size_t WordsFor(std::size_t rows, unsigned bits)
+	{
+		return std::max<std::size_t>(
+			static_cast<std::size_t>((uint64_t(rows) * bits + 63) / 64) + 1, 2);
+	}
+
+	// Re-encodes the current values at a new bias and width.
+	void Repack(int32_t newBias, unsigned newBits)
+	{
+		PackedColumn wider;
+		wider.bias = newBias;
+		wider.bits = newBits;
+		wider.reserved = reserved;
+		wider.words.reserve(WordsFor(std::max(reserved, size), newBits));
+		wider.words.assign(WordsFor(size, newBits), 0);
+		for (std::size_t i = 0; i < size; i++)
+		{
+			wider.Put(i, static_cast<uint32_t>(int64_t(Get(i)) - newBias));
+		}
+		wider.size = size;
+		Swap(wider);
+	}
+};
+
+namespace packed_detail
+{
+// Widest key range sorted by counting (4 bytes per possible key).
+constexpr unsigned kMaxCountingBits = 24;
+// Smallest counting table always allowed (fits in L2), however few rows.
+constexpr std::size_t kMinCountingRange = std::size_t(1) << 16;
+// Pairs per ParallelSum chunk, and values unpacked per kernel call.
+constexpr std::size_t kGrain = std::size_t(1) << 20;
+constexpr std::size_t kUnpackBlock = 1024;
+
+// Counting is worth it while the table isn't much bigger than the column.
+inline bool Countable(const PackedColumn &column)
+{
+	std::size_t range = std::size_t(1) << column.Bits();
+	return column.Bits() <= kMaxCountingBits &&
+		   (range <= 2 * column.Size() || range <= kMinCountingRange);
+}
+
+// Counting sort: one histogram pass, then the column is rewritten from the
+// histogram, in place. With a pool, each worker counts its own slice, and
+// the rewrite is split at 64-aligned output positions so no two writers share
+// a word. 'grain' is the fewest keys per parallel task.
+inline void CountingSort(PackedColumn &column, WorkStealingPool *pool,
+						 std::size_t grain = kGrain)
+{
+	const std::size_t n = column.Size();
+	const std::size_t range = std::size_t(1) << column.Bits();
+	// Per-worker histograms only while they stay small next to the column
+	if (pool && (pool->Size() == 1 || range * pool->Size() > n))
+	{
+		pool = nullptr;
+	}
+	const std::size_t workers = pool ? pool->Size() : 1;
+	std::vector<uint32_t> counts(range * workers, 0);
+	auto count = [&](std::size_t begin, std::size_t end, std::size_t worker)
+	{
+		uint32_t *mine = counts.data() + worker * range;
+		for (std::size_t i = begin; i < end; i++)
+		{
+			mine[column.Key(i)]++;
+		}
+	};
+	if (pool)
+	{
+		pool->ParallelFor(n, grain, count);
+		for (std::size_t w = 1; w < workers; w++)
+		{
+			for (std::size_t k = 0; k < range; k++)
+			{
+				counts[k] += counts[w * range + k];
+			}
+		}
+	}
+	else
+	{
+		count(0, n, 0);
+	}
+	counts.resize(range);
+
+	// The histogram holds the whole sorted column, so the keys are
+	// rewritten over themselves.
+	column.ZeroKeys();
+	if (!pool)
+	{
+		std::size_t pos = 0;
+		for (std::size_t k = 0; k < range; k++)
+		{
+			for (uint32_t c = counts[k]; c > 0; c--)
+			{
+				column.Put(pos++, static_cast<uint32_t>(k));
+			}
+		}
+		return;
+	}
+	// starts[k]: first output position of key k
+	std::vector<std::size_t> starts(range + 1, 0);
+	for (std::size_t k = 0; k < range; k++)
+	{
+		starts[k + 1] = starts[k] + counts[k];
+	}
+	const std::size_t blocks = (n + 63) / 64;
+	pool->ParallelFor(
+		blocks, std::max<std::size_t>(1, grain / 64),
+		[&](std::size_t begin, std::size_t end, std::size_t)
+		{
+			std::size_t pos = begin * 64, stop = std::min(n, end * 64);
+			std::size_t k = static_cast<std::size_t>(
+				std::upper_bound(starts.begin(), starts.end(), pos) -
+				starts.begin() - 1);
+			for (; pos < stop; pos++)
+			{
+				while (starts[k + 1] <= pos)
+				{
+					k++;
+				}
+				column.Put(pos, static_cast<uint32_t>(k));
+			}
+		});
+}
+
+// LSD radix sort of the packed keys with 11-bit digits, ping-ponging with a
+// packed scratch column. The peak is two packed columns, never more than the
+// int32_t radix sort's keys plus scratch.
+inline void RadixSort(PackedColumn &column)
+{
+	constexpr unsigned kDigitBits = 11;
+	constexpr std::size_t kBuckets = std::size_t(1) << kDigitBits;
+	const std::size_t n = column.Size();
+	std::vector<std::size_t> next(kBuckets);
+	for (unsigned shift = 0; shift < column.Bits(); shift += kDigitBits)
+	{
+		std::fill(next.begin(), next.end(), 0);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			next[(column.Key(i) >> shift) & (kBuckets - 1)]++;
+		}
+		std::size_t offset = 0;
+		for (std::size_t &slot : next)
+		{
+			std::size_t c = slot;
+			slot = offset;
+			offset += c;
+		}
+		PackedColumn out = column.SameShape(n);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			uint32_t key = column.Key(i);
+			out.Put(next[(key >> shift) & (kBuckets - 1)]++, key);
+		}
+		column.Swap(out);
+	}
+}
+} // namespace packed_detail
+
+/**
+ * @brief Sorts a packed column in place: by counting when its key range is
+ * small next to its length (always the case for 5-digit IDs), by an LSD radix
+ * sort over the packed keys otherwise. With a pool, counting runs in tasks of
+ * at least 'grain' keys.
+ */
+inline void SortPackedColumn(PackedColumn &column,
+							 WorkStealingPool *pool = nullptr,
+							 std::size_t grain = packed_detail::kGrain)
+{
+	if (column.Size() < 2 || column.Bits() == 0)
+	{
+		return;
+	}
+	if (packed_detail::Countable(column))
+	{
+		packed_detail::CountingSort(column, pool, grain);
+	}
+	else
+	{
+		packed_detail::RadixSort(column);
+	}
+}
+
+/**
+ * @brief sum(|a[i] - b[i]|) over two packed columns of equal length. Blocks
+ * of pairs are unpacked into stack buffers and reduced by ColumnDistance's
+ * SIMD kernel; with a pool, 1M-pair chunks run on every thread.
+ */
+inline int64_t PackedDistance(const PackedColumn &a, const PackedColumn &b,
+							  WorkStealingPool *pool = nullptr)
+{
+	using namespace packed_detail;
+	const std::size_t n = std::min(a.Size(), b.Size());
+	auto chunk = [&](std::size_t begin, std::size_t end)
+	{
+		int32_t left[kUnpackBlock], right[kUnpackBlock];
+		int64_t sum = 0;
+		for (std::size_t i = begin; i < end; i += kUnpackBlock)
+		{
+			std::size_t m = std::min(kUnpackBlock, end - i);
+			a.Unpack(i, m, left);
+			b.Unpack(i, m, right);
+			sum += ColumnDistance(left, right, m);
+		}
+		return sum;
+	};
+	if (!pool || n <= kGrain)
+	{
+		return chunk(0, n);
+	}
+	return pool->ParallelSum<int64_t>(n, kGrain, chunk);
+}
+
+/**
+ * @brief Day 1's similarity score of two sorted packed columns, as one merge
+ * over equal-value runs (the packed counterpart of SimilarityFromSorted).
+ */
+inline int64_t PackedSimilaritySorted(const PackedColumn &left,
+									  const PackedColumn &right)
+{
+	int64_t total = 0;
+	std::size_t i = 0, j = 0;
+	while (i < left.Size() && j < right.Size())
+	{
+		int32_t a = left.Get(i), b = right.Get(j);
+		if (a < b)
+		{
+			i++;
+		}
+		else if (b < a)
+		{
+			j++;
+		}
+		else
+		{
+			int64_t runLeft = 0, runRight = 0;
+			for (; i < left.Size() && left.Get(i) == a; i++)
+			{
+				runLeft++;
+			}
+			for (; j < right.Size() && right.Get(j) == a; j++)
+			{
+				runRight++;
+			}
+			total += int64_t(a) * runLeft * runRight;
+		}
+	}
+	return total;
+}
+
+/**
+ * @brief Day 1's similarity score of two unsorted packed columns, from a
+ * dense histogram of right's keys (the packed counterpart of ValueCounter).
+ * @return false, leaving 'total' alone, when right's key range is too wide
+ * to count densely; sort both columns and use PackedSimilaritySorted then.
+ */
+inline bool PackedSimilarityCounted(const PackedColumn &left,
+									const PackedColumn &right, int64_t &total)
+{
+	if (!packed_detail::Countable(right))
+	{
+		return false;
+	}
+	std::vector<uint32_t> counts(std::size_t(1) << right.Bits(), 0);
+	for (std::size_t j = 0; j < right.Size(); j++)
+	{
+		counts[right.Key(j)]++;
+	}
+	int64_t sum = 0;
+	for (std::size_t i = 0; i < left.Size(); i++)
+	{
+		int64_t v = left.Get(i);
+		// One unsigned compare covers both v < bias and v past the range
+		uint64_t key = static_cast<uint64_t>(v - right.Bias());
+		sum += key < counts.size() ? v * counts[key] : 0;
+	}
+	total = sum;
+	return true;
+}
+
+#endif // AOC_PACKED_COLUMN_H
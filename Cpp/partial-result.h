@@ -0,0 +1,147 @@
+#ifndef AOC_PARTIAL_RESULT_H
+#define AOC_PARTIAL_RESULT_H
+
+#include <cstddef>	  // For std::size_t
+#include <cstdint>	  // For int32_t, int64_t, uint64_t
+#include <functional> // For std::greater
+#include <istream>	  // For std::istream
+#include <ostream>	  // For std::ostream
+#include <queue>	  // For std::priority_queue
+#include <string>	  // For std::string
+#include <utility>	  // For std::pair
+#include <vector>	  // For std::vector
+
+/**
+ * Mergeable partial results, for datasets split into shards that are solved
+ * apart (in worker processes, or on other nodes) and combined afterwards.
+ *
+ * A shard maps to two kinds of state: sums that simply add up across shards
+ * (Day 2's safe report counts), and a sorted run of distinct values with
+ * their per-column counts (Day 1's lists). Runs from any number of shards
+ * k-way merge into the histogram of the whole dataset, which determines
+ * both of Day 1's answers exactly. Partials travel as text:
+ *   partial <ok> <sum1> <sum2> <runs>
+ *   <value> <left count> <right count>     (one line per run)
+ */
+
+// One distinct value and how often it occurs in each column.
+struct ValueRun
+{
+	int32_t value;
+	uint64_t left;
+	uint64_t right;
+};
+
+// A shard's contribution to a day's answers.
+struct PartialResult
+{
+	bool ok = true;			   // false if the shard failed to load
+	int64_t sums[2] = {0, 0};  // Added across shards
+	std::vector<ValueRun> runs; // Ascending by value; merged across shards
+
+	void Write(std::ostream &out) const
+	{
+		out << "partial " << ok << ' ' << sums[0] << ' ' << sums[1] << ' '
+			<< runs.size() << '\n';
+		for (const ValueRun &run : runs)
+		{
+			out << run.value << ' ' << run.left << ' ' << run.right << '\n';
+		}
+	}
+
+	// @return false at end of input or on a malformed record, including one
+	// whose values do not strictly ascend.
+	bool Read(std::istream &in)
+	{
+		std::string tag;
+		std::size_t count = 0;
+		if (!(in >> tag >> ok >> sums[0] >> sums[1] >> count) ||
+			tag != "partial")
+		{
+			return false;
+		}
+		// The count comes from outside, so runs are read one at a time rather
+		// than sized up front: a corrupt count ends at the input's end.
+		runs.clear();
+		for (std::size_t r = 0; r < count; r++)
+		{
+			ValueRun run;
+			if (!(in >> run.value >> run.left >> run.right) ||
+				(!runs.empty() && run.value <= runs.back().value))
+			{
+				return false;
+			}
+			runs.push_back(run);
+		}
+		return true;
+	}
+};
+
+/**
+ * @brief Appends to 'runs' the distinct values of two ascending sequences,
+ * left(i) for i < n and right(j) for j < m, with their counts in each.
+ */
+template <typename Left, typename Right>
+void AppendValueRuns(std::size_t n, Left &&left, std::size_t m, Right &&right,
+					 std::vector<ValueRun> &runs)
+{
+	std::size_t i = 0, j = 0;
+	while (i < n || j < m)
+	{
+		int32_t value = i == n		  ? right(j)
+						: j == m	  ? left(i)
+						: left(i) < right(j) ? left(i)
+											 : right(j);
+		ValueRun run{value, 0, 0};
+		for (; i < n && left(i) == value; i++)
+		{
+			run.left++;
+		}
+		for (; j < m && right(j) == value; j++)
+		{
+			run.right++;
+		}
+		runs.push_back(run);
+	}
+}
+
+/**
+ * @brief k-way merges the runs of every partial: calls fn(value, left,
+ * right) once per distinct value, in ascending order, with its counts summed
+ * over all shards.
+ */
+template <typename Fn>
+void MergeValueRuns(const std::vector<PartialResult> &partials, Fn &&fn)
+{
+	// (value, partial index) of each partial's next run; smallest on top
+	using Head = std::pair<int32_t, std::size_t>;
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+	std::vector<std::size_t> next(partials.size(), 0);
+	for (std::size_t p = 0; p < partials.size(); p++)
+	{
+		if (!partials[p].runs.empty())
+		{
+			heads.push({partials[p].runs[0].value, p});
+		}
+	}
+	while (!heads.empty())
+	{
+		int32_t value = heads.top().first;
+		uint64_t left = 0, right = 0;
+		while (!heads.empty() && heads.top().first == value)
+		{
+			std::size_t p = heads.top().second;
+			heads.pop();
+			const ValueRun &run = partials[p].runs[next[p]++];
+			left += run.left;
+			right += run.right;
+			if (next[p] < partials[p].runs.size())
+			{
+				heads.push({partials[p].runs[next[p]].value, p});
+			}
+		}
+		fn(value, left, right);
+	}
+}
+
+#endif // AOC_PARTIAL_RESULT_H
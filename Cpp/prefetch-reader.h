@@ -0,0 +1,687 @@
+#ifndef AOC_PREFETCH_READER_H
+#define AOC_PREFETCH_READER_H
+
+#include <algorithm>			  // For std::min
+#include <atomic>			  // For std::atomic
+#include <condition_variable> // For std::condition_variable (thread backend)
+#include <cstddef>			  // For std::size_t
+#include <cstdint>			  // For uint64_t
+#include <cstring>			  // For std::memcpy, std::memchr
+#include <deque>			  // For std::deque (thread backend queue)
+#include <iostream>			  // For std::cerr
+#include <memory>			  // For std::unique_ptr
+#include <mutex>			  // For std::mutex, std::unique_lock
+#include <string>			  // For std::string
+#include <string_view>		  // For std::string_view
+#include <thread>			  // For std::thread
+#include <vector>			  // For std::vector
+
+#include "line-stream.h" // For ByteSource
+#include "profile.h"	 // For AOC_PROFILE_SCOPE, AOC_PROFILE_COUNT
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>	  // For errno, EINTR
+#include <fcntl.h>	  // For open
+#include <sys/stat.h> // For fstat, S_ISREG
+#include <unistd.h>	  // For read, close
+#define AOC_HAVE_POSIX_IO 1
+#else
+#define AOC_HAVE_POSIX_IO 0
+#endif
+
+// io_uring through raw syscalls (no liburing): needs Linux headers new enough
+// to describe it. The kernel may still refuse it at runtime (old kernels,
+// seccomp sandboxes), in which case the reader uses its thread backend.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h> // For io_uring_params, io_uring_sqe, io_uring_cqe
+#include <sys/mman.h>		// For mmap, munmap
+#include <sys/syscall.h>	// For __NR_io_uring_setup, __NR_io_uring_enter
+#include <sys/uio.h>		// For iovec
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define AOC_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+#ifndef AOC_HAVE_IO_URING
+#define AOC_HAVE_IO_URING 0
+#endif
+
+// How PrefetchReader issues its reads.
+enum class PrefetchBackend
+{
+	Auto,	 // io_uring when the kernel allows it, the thread otherwise
+	IoUring, // Fails to open if io_uring is unavailable
+	Thread,	 // One background thread doing blocking reads
+};
+
+/**
+ * @brief Parses a prefetch backend name ("auto", "io_uring", "thread").
+ * @return false if the name is not recognised.
+ */
+inline bool PrefetchBackendFromName(std::string_view name,
+									PrefetchBackend &backend)
+{
+	if (name == "auto")
+	{
+		backend = PrefetchBackend::Auto;
+	}
+	else if (name == "io_uring")
+	{
+		backend = PrefetchBackend::IoUring;
+	}
+	else if (name == "thread")
+	{
+		backend = PrefetchBackend::Thread;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+#if AOC_HAVE_IO_URING
+/**
+ * @brief The smallest io_uring wrapper the reader needs: submit READV for a
+ * buffer at an offset, and reap completions. Not thread-safe.
+ */
+class IoUring
+{
+public:
+	IoUring() = default;
+	~IoUring() { Close(); }
+
+	IoUring(const IoUring &) = delete;
+	IoUring &operator=(const IoUring &) = delete;
+
+	bool Open(unsigned entries)
+	{
+		io_uring_params params{};
+		int fd = static_cast<int>(
+			::syscall(__NR_io_uring_setup, entries, &params));
+		if (fd < 0)
+		{
+			return false;
+		}
+		ringFd = fd;
+		sqBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			sqBytes = cqBytes = sqBytes > cqBytes ? sqBytes : cqBytes;
+		}
+		sqRing = ::mmap(nullptr, sqBytes, PROT_READ | PROT_WRITE,
+						MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+		if (sqRing == MAP_FAILED)
+		{
+			sqRing = nullptr;
+			Close();
+			return false;
+		}
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			cqRing = sqRing;
+		}
+		else
+		{
+			cqRing = ::mmap(nullptr, cqBytes, PROT_READ | PROT_WRITE,
+							MAP_SHARED | MAP_POPULATE, ringFd,
+							IORING_OFF_CQ_RING);
+			if (cqRing == MAP_FAILED)
+			{
+				cqRing = nullptr;
+				Close();
+				return false;
+			}
+		}
+		sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+		void *s = ::mmap(nullptr, sqeBytes, PROT_READ | PROT_WRITE,
+						 MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (s == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+		sqes = static_cast<io_uring_sqe *>(s);
+
+		char *sq = static_cast<char *>(sqRing);
+		sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+		char *cq = static_cast<char *>(cqRing);
+		cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	void Close()
+	{
+		if (sqes)
+		{
+			::munmap(sqes, sqeBytes);
+		}
+		if (cqRing && cqRing != sqRing)
+		{
+			::munmap(cqRing, cqBytes);
+		}
+		if (sqRing)
+		{
+			::munmap(sqRing, sqBytes);
+		}
+		if (ringFd >= 0)
+		{
+			::close(ringFd);
+		}
+		sqes = nullptr;
+		sqRing = cqRing = nullptr;
+		ringFd = -1;
+	}
+
+	// Queues and submits one vectored read of 'vec' from 'fd' at 'offset'.
+	bool SubmitRead(int fd, const iovec *vec, uint64_t offset, uint64_t tag)
+	{
+		unsigned tail = *sqTail;
+		unsigned index = tail & sqMask;
+		io_uring_sqe &sqe = sqes[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = IORING_OP_READV;
+		sqe.fd = fd;
+		sqe.addr = reinterpret_cast<uint64_t>(vec);
+		sqe.len = 1;
+		sqe.off = offset;
+		sqe.user_data = tag;
+		sqArray[index] = index;
+		__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+		return Enter(1, 0, 0);
+	}
+
+	/**
+	 * @brief Waits for at least one completion and passes each one to
+	 * fn(tag, result), where result is bytes read or -errno.
+	 */
+	template <typename Fn>
+	bool Reap(Fn &&fn)
+	{
+		unsigned head = *cqHead;
+		if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE) &&
+			!Enter(0, 1, IORING_ENTER_GETEVENTS))
+		{
+			return false;
+		}
+		for (; head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE); head++)
+		{
+			const io_uring_cqe &cqe = cqes[head & cqMask];
+			fn(cqe.user_data, cqe.res);
+		}
+		__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+		return true;
+	}
+
+private:
+	int ringFd = -1;
+	void *sqRing = nullptr;
+	void *cqRing = nullptr;
+	io_uring_sqe *sqes = nullptr;
+	std::size_t sqBytes = 0, cqBytes = 0, sqeBytes = 0;
+	unsigned *sqTail = nullptr, *sqArray = nullptr;
+	unsigned *cqHead = nullptr, *cqTail = nullptr;
+	unsigned sqMask = 0, cqMask = 0;
+	io_uring_cqe *cqes = nullptr;
+
+	bool Enter(unsigned submit, unsigned wait, unsigned flags)
+	{
+		for (;;)
+		{
+			long r = ::syscall(__NR_io_uring_enter, ringFd, submit, wait, flags,
+							   nullptr, 0);
+			if (r >= 0)
+			{
+				return true;
+			}
+			if (errno != EINTR)
+			{
+				return false;
+			}
+		}
+	}
+};
+#endif // AOC_HAVE_IO_URING
+
+/**
+ * @brief Reads a file as a sequence of large blocks, keeping 'depth' reads in
+ * flight ahead of the consumer so I/O overlaps with whatever the caller does
+ * with the blocks (typically parsing). Blocks come back in file order from
+ * Next(); each stays valid until the following call, which hands its buffer
+ * back for the next read.
+ *
+ * The io_uring backend reads every block at its own offset, all 'depth' of
+ * them concurrently, which is what hides the latency of network storage. The
+ * thread backend runs one background thread doing read() into the ring; it
+ * also serves pipes and other non-seekable inputs.
+ */
+class PrefetchReader
+{
+public:
+	explicit PrefetchReader(std::size_t blockBytes = std::size_t(4) << 20,
+							std::size_t depth = 4)
+		: blockBytes(blockBytes > 0 ? blockBytes : 1),
+		  slots(depth > 1 ? depth : 2)
+	{
+	}
+
+	~PrefetchReader() { Close(); }
+
+	PrefetchReader(const PrefetchReader &) = delete;
+	PrefetchReader &operator=(const PrefetchReader &) = delete;
+
+	/**
+	 * @brief Opens 'path' and starts the first 'depth' reads.
+	 * @return false if the file can't be opened, or the requested backend is
+	 * unavailable.
+	 */
+	bool Open(const std::string &path,
+			  PrefetchBackend backend = PrefetchBackend::Auto)
+	{
+		AOC_PROFILE_SCOPE(Open);
+		Close();
+#if AOC_HAVE_POSIX_IO
+		fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat st;
+		seekable = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+		fileSize = seekable ? static_cast<uint64_t>(st.st_size) : 0;
+		for (Slot &slot : slots)
+		{
+			slot.data.resize(blockBytes);
+		}
+#if AOC_HAVE_IO_URING
+		if (backend != PrefetchBackend::Thread && seekable &&
+			ring.Open(static_cast<unsigned>(slots.size())))
+		{
+			useRing = true;
+		}
+#endif
+		if (!useRing && backend == PrefetchBackend::IoUring)
+		{
+			Close();
+			return false;
+		}
+		if (!useRing)
+		{
+			worker = std::thread([this] { WorkerLoop(); });
+		}
+		for (std::size_t s = 0; s < slots.size(); s++)
+		{
+			Submit(s);
+		}
+		return !failed;
+#else
+		(void)path;
+		(void)backend;
+		return false;
+#endif
+	}
+
+	/**
+	 * @brief Waits for the next block of the file.
+	 * @return false at end of file or on a read error (see Failed()).
+	 */
+	bool Next(std::string_view &block)
+	{
+		if (held)
+		{
+			// The previous block is done with: reuse its buffer further on
+			held = false;
+			Submit(next);
+			next = (next + 1) % slots.size();
+		}
+		if (failed || !WaitReady(next))
+		{
+			return false;
+		}
+		Slot &slot = slots[next];
+		if (slot.filled == 0)
+		{
+			return false;
+		}
+		held = true;
+		block = std::string_view(slot.data.data(), slot.filled);
+		AOC_PROFILE_COUNT(BytesRead, slot.filled);
+		return true;
+	}
+
+	bool Failed() const { return failed; }
+	const char *BackendName() const { return useRing ? "io_uring" : "thread"; }
+
+	void Close()
+	{
+#if AOC_HAVE_POSIX_IO
+		if (worker.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_all();
+			worker.join();
+		}
+#if AOC_HAVE_IO_URING
+		// The kernel may still be writing into the buffers: drain first
+		while (useRing && inFlight > 0 &&
+			   ring.Reap([&](uint64_t, int) { inFlight--; }))
+		{
+		}
+		ring.Close();
+#endif
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+#endif
+		fd = -1;
+		useRing = false;
+		failed = false;
+		stop = held = false;
+		inFlight = 0;
+		next = 0;
+		nextOffset = 0;
+		queue.clear();
+		for (Slot &slot : slots)
+		{
+			slot.state = SlotState::Idle;
+			slot.filled = 0;
+		}
+	}
+
+private:
+	enum class SlotState
+	{
+		Idle,	 // Nothing left to read into it
+		Pending, // A read is queued or in flight
+		Ready,	 // Filled, waiting for the consumer
+	};
+
+	struct Slot
+	{
+		std::vector<char> data;
+		std::size_t filled = 0;
+		std::size_t want = 0;
+		uint64_t offset = 0;
+		SlotState state = SlotState::Idle;
+#if AOC_HAVE_IO_URING
+		iovec vec{};
+#endif
+	};
+
+	const std::size_t blockBytes;
+	std::vector<Slot> slots;
+	int fd = -1;
+	bool seekable = false;
+	uint64_t fileSize = 0;
+	uint64_t nextOffset = 0; // File offset of the next block to submit
+	std::size_t next = 0;	 // Slot holding the next block in file order
+	bool held = false;		 // The consumer holds slots[next]
+	std::atomic<bool> failed{false};
+	bool useRing = false;
+	std::size_t inFlight = 0;
+#if AOC_HAVE_IO_URING
+	IoUring ring;
+#endif
+
+	// Thread backend: the worker fills the queued slots in order.
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;  // Signals the worker
+	std::condition_variable ready; // Signals the consumer
+	std::deque<std::size_t> queue;
+	bool stop = false;
+
+	// Starts reading the next block of the file into slot 's'.
+	void Submit(std::size_t s)
+	{
+		Slot &slot = slots[s];
+		slot.filled = 0;
+		if (seekable && nextOffset >= fileSize)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			slot.state = SlotState::Idle;
+			return;
+		}
+		slot.offset = nextOffset;
+		slot.want = seekable ? static_cast<std::size_t>(std::min<uint64_t>(
+								   blockBytes, fileSize - nextOffset))
+							 : blockBytes;
+		nextOffset += slot.want;
+#if AOC_HAVE_IO_URING
+		if (useRing)
+		{
+			slot.state = SlotState::Pending;
+			SubmitRing(s);
+			return;
+		}
+#endif
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			slot.state = SlotState::Pending;
+			queue.push_back(s);
+		}
+		wake.notify_one();
+	}
+
+#if AOC_HAVE_IO_URING
+	void SubmitRing(std::size_t s)
+	{
+		Slot &slot = slots[s];
+		slot.vec.iov_base = slot.data.data() + slot.filled;
+		slot.vec.iov_len = slot.want - slot.filled;
+		if (!ring.SubmitRead(fd, &slot.vec, slot.offset + slot.filled, s))
+		{
+			failed = true;
+			return;
+		}
+		inFlight++;
+	}
+#endif
+
+	// Blocks until slot 's' is no longer pending. False on error.
+	bool WaitReady(std::size_t s)
+	{
+		AOC_PROFILE_SCOPE(Read);
+		Slot &slot = slots[s];
+#if AOC_HAVE_IO_URING
+		if (useRing)
+		{
+			while (!failed && slot.state == SlotState::Pending)
+			{
+				bool ok = ring.Reap(
+					[&](uint64_t tag, int result)
+					{
+						inFlight--;
+						Slot &done = slots[tag];
+						if (result == -EINTR || result == -EAGAIN)
+						{
+							SubmitRing(tag);
+						}
+						else if (result < 0)
+						{
+							failed = true;
+						}
+						else if (result == 0 || (done.filled += result) ==
+													 done.want)
+						{
+							// Done, or the file shrank under us
+							done.state = SlotState::Ready;
+						}
+						else
+						{
+							// Short read (e.g. network storage): read the rest
+							SubmitRing(tag);
+						}
+					});
+				if (!ok)
+				{
+					failed = true;
+				}
+			}
+			return !failed;
+		}
+#endif
+		std::unique_lock<std::mutex> lock(mutex);
+		ready.wait(lock, [&] { return slot.state != SlotState::Pending; });
+		return !failed;
+	}
+
+	void WorkerLoop()
+	{
+#if AOC_HAVE_POSIX_IO
+		bool ended = false;
+		for (;;)
+		{
+			std::size_t s;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&] { return stop || !queue.empty(); });
+				if (stop)
+				{
+					return;
+				}
+				s = queue.front();
+				queue.pop_front();
+			}
+			Slot &slot = slots[s];
+			bool error = false;
+			// Blocking reads until the block is full or the input ends
+			while (!ended && slot.filled < slot.want)
+			{
+				ssize_t got = ::read(fd, slot.data.data() + slot.filled,
+									 slot.want - slot.filled);
+				if (got < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				if (got <= 0)
+				{
+					error = got < 0;
+					ended = true;
+					break;
+				}
+				slot.filled += static_cast<std::size_t>(got);
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (error)
+				{
+					failed = true;
+				}
+				slot.state = SlotState::Ready;
+			}
+			ready.notify_one();
+		}
+#endif
+	}
+};
+
+/**
+ * @brief ByteSource over a PrefetchReader, for consumers built on LineStream.
+ * Costs one copy per byte; callers that can work on whole blocks should use
+ * ForEachLineBlock instead.
+ */
+class PrefetchSource : public ByteSource
+{
+public:
+	explicit PrefetchSource(PrefetchReader &reader) : reader(reader) {}
+
+	std::size_t Read(char *dst, std::size_t capacity) override
+	{
+		if (rest.empty() && !reader.Next(rest))
+		{
+			return 0;
+		}
+		std::size_t n = rest.size() < capacity ? rest.size() : capacity;
+		std::memcpy(dst, rest.data(), n);
+		rest.remove_prefix(n);
+		return n;
+	}
+
+	bool Failed() const override { return reader.Failed(); }
+
+private:
+	PrefetchReader &reader;
+	std::string_view rest;
+};
+
+/**
+ * @brief Calls fn(std::string_view text) with the blocks of 'reader' cut at
+ * line boundaries: every text passed holds whole lines only (the last one may
+ * lack its '\n' at end of file). A line split between two blocks is joined in
+ * a small side buffer, so the blocks themselves are never copied. fn runs
+ * while the next reads are in flight.
+ * @return false if reading failed part-way through.
+ */
+template <typename Fn>
+bool ForEachLineBlock(PrefetchReader &reader, Fn &&fn)
+{
+	std::string seam; // The unfinished line carried from the last block
+	std::string_view block;
+	while (reader.Next(block))
+	{
+		if (!seam.empty())
+		{
+			const void *nl = std::memchr(block.data(), '\n', block.size());
+			if (!nl)
+			{
+				seam.append(block);
+				continue;
+			}
+			std::size_t head = static_cast<std::size_t>(
+								   static_cast<const char *>(nl) - block.data()) +
+							   1;
+			seam.append(block.substr(0, head));
+			fn(std::string_view(seam));
+			seam.clear();
+			block.remove_prefix(head);
+		}
+		std::size_t last = block.rfind('\n');
+		if (last == std::string_view::npos)
+		{
+			seam.assign(block);
+			continue;
+		}
+		fn(block.substr(0, last + 1));
+		seam.assign(block.substr(last + 1));
+	}
+	if (!seam.empty())
+	{
+		fn(std::string_view(seam));
+	}
+	return !reader.Failed();
+}
+
+/**
+ * @brief Opens 'path' with a PrefetchReader and runs ForEachLineBlock over it,
+ * reporting failures on std::cerr.
+ */
+template <typename Fn>
+bool ReadLineBlocks(const std::string &path, PrefetchBackend backend, Fn &&fn)
+{
+	PrefetchReader reader;
+	if (!reader.Open(path, backend))
+	{
+		std::cerr << "ERROR: Unable to open file at path: " << path << std::endl;
+		return false;
+	}
+	if (!ForEachLineBlock(reader, fn))
+	{
+		std::cerr << "ERROR: Read failed in " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#endif // AOC_PREFETCH_READER_H
@@ -0,0 +1,462 @@
+#ifndef AOC_PROFILE_H
+#define AOC_PROFILE_H
+
+/**
+ * Phase timers and event counters for the --profile mode.
+ *
+ * Build with -DAOC_PROFILE to compile them in; otherwise every AOC_PROFILE_*
+ * macro expands to nothing and the solvers carry no trace of them. Even when
+ * compiled in, nothing is recorded until profile::Enable() is called (the
+ * mains do so for --profile), and a disabled timer costs one branch.
+ *
+ *   AOC_PROFILE_SCOPE(Parse);               // time the rest of this scope
+ *   AOC_PROFILE_COUNT(BytesRead, n);        // add n to a counter
+ *   AOC_PROFILE_ALLOCATION_HOOK();          // once per program, at file scope
+ *   AOC_PROFILE_REPORT("day1");             // print JSON to stderr at scope end
+ *
+ * Phases are inclusive: a phase that runs inside another is counted in both.
+ * Stats are process-wide and thread-safe (relaxed atomics).
+ *
+ * On Linux each phase also records hardware events from perf_event_open:
+ * cycles, instructions (reported with their ratio, IPC), branch misses and
+ * last-level cache misses. The counters are opened by Enable() with
+ * inherit set, so they follow every thread started afterwards (the solvers'
+ * pools included) and a phase's figures cover the work it hands to them.
+ * Like the timers they are process-wide: phases overlapping on separate
+ * threads (runner --concurrent) share their events. Events the host won't
+ * open (perf_event_paranoid > 2, VMs without a PMU) are left out, and
+ * "hw_counters" in the report lists the ones that were recorded.
+ *
+ * Profiling build, with symbols and frame pointers so that perf's
+ * frame-pointer unwinding (perf record --call-graph fp) gives whole stacks
+ * for flame graphs:
+ *   g++ -std=c++17 -O2 -g -fno-omit-frame-pointer -mno-omit-leaf-frame-pointer
+ *       -pthread -DAOC_PROFILE -DAOC_RUNNER runner.cpp day-01.cpp day-02.cpp
+ *   perf record --call-graph fp ./a.out --profile
+ */
+
+#ifdef AOC_PROFILE
+
+#include <atomic>	// For std::atomic
+#include <chrono>	// For std::chrono::steady_clock
+#include <cstddef>	// For std::size_t
+#include <cstdint>	// For uint64_t
+#include <cstdlib>	// For std::malloc, std::aligned_alloc, std::free
+#include <iostream> // For std::ostream
+#include <new>		// For std::bad_alloc, std::align_val_t
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // For __rdtsc
+#endif
+
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h> // For perf_event_attr, PERF_COUNT_HW_*
+#include <sys/syscall.h>	  // For SYS_perf_event_open
+#include <unistd.h>			  // For syscall, read
+#define AOC_HAVE_PERF_EVENT 1
+#else
+#define AOC_HAVE_PERF_EVENT 0
+#endif
+
+namespace profile
+{
+enum class Phase
+{
+	Open,
+	Read,
+	Decompress,
+	Parse,
+	Sort,
+	Distance,
+	Count,
+	Classify,
+	Dampen,
+	kCount,
+};
+
+enum class Counter
+{
+	BytesRead,
+	Allocations,
+	DampenedReports,  // Day 2 reports not known safe, so checked by the dampener
+	CandidatesTried,  // Day 2 removals (or rescans) tested by the dampener
+	UnsafeFlat,		  // Day 2 reports failing first on two equal levels
+	UnsafeReversed,	  // ... on a step against the report's direction
+	UnsafeTooFar,	  // ... on a step of more than 3
+	ColumnBytes,	  // Day 1 heap bytes holding the loaded columns
+	kCount,
+};
+
+// Hardware events sampled around every phase.
+enum class HwEvent
+{
+	Cycles,
+	Instructions,
+	BranchMisses,
+	LlcMisses,
+	kCount,
+};
+
+inline const char *PhaseName(Phase phase)
+{
+	static const char *const names[] = {"open",	  "read",	  "decompress",
+										"parse",	  "sort",	  "distance",
+										"count",	  "classify", "dampen"};
+	return names[static_cast<std::size_t>(phase)];
+}
+
+inline const char *CounterName(Counter counter)
+{
+	static const char *const names[] = {
+		"bytes_read",		"allocations",	   "dampened_reports",
+		"candidates_tried", "unsafe_flat",	   "unsafe_reversed",
+		"unsafe_too_far",	"column_bytes"};
+	return names[static_cast<std::size_t>(counter)];
+}
+
+inline const char *HwEventName(HwEvent event)
+{
+	static const char *const names[] = {"cycles", "instructions",
+										"branch_misses", "llc_misses"};
+	return names[static_cast<std::size_t>(event)];
+}
+
+constexpr std::size_t kHwEvents = static_cast<std::size_t>(HwEvent::kCount);
+
+/**
+ * @brief One perf_event counter per HwEvent for the whole process. Each is
+ * opened on its own rather than as a group, so a host missing one event
+ * (commonly the LLC one in VMs) still records the rest.
+ */
+class HwCounters
+{
+public:
+	// Opens the events that the host allows; the others stay closed.
+	void Open()
+	{
+#if AOC_HAVE_PERF_EVENT
+		static const uint64_t configs[] = {
+			PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+		for (std::size_t e = 0; e < kHwEvents; e++)
+		{
+			if (fds[e] >= 0)
+			{
+				continue;
+			}
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[e];
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.inherit = 1; // Count the threads started from here on too
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+							   PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fds[e] = static_cast<int>(
+				syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		}
+#endif
+	}
+
+	bool Available(HwEvent event) const
+	{
+		return fds[static_cast<std::size_t>(event)] >= 0;
+	}
+
+	/**
+	 * @brief Current totals of the open events, scaled up for the time the
+	 * kernel multiplexed them off the PMU; closed events read as 0.
+	 */
+	void Read(uint64_t (&values)[kHwEvents]) const
+	{
+		for (std::size_t e = 0; e < kHwEvents; e++)
+		{
+			values[e] = 0;
+#if AOC_HAVE_PERF_EVENT
+			// value, time enabled, time running
+			uint64_t sample[3];
+			if (fds[e] >= 0 &&
+				read(fds[e], sample, sizeof(sample)) == sizeof(sample) &&
+				sample[2] > 0)
+			{
+				values[e] = sample[2] == sample[1]
+								? sample[0]
+								: static_cast<uint64_t>(double(sample[0]) *
+														sample[1] / sample[2]);
+			}
+#endif
+		}
+	}
+
+private:
+	int fds[kHwEvents] = {-1, -1, -1, -1};
+};
+
+// Raw timestamp counter: TSC ticks on x86, the virtual counter on AArch64.
+inline uint64_t Cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t ticks;
+	asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+#else
+	return 0;
+#endif
+}
+
+struct PhaseStats
+{
+	std::atomic<uint64_t> calls{0};
+	std::atomic<uint64_t> nanos{0};
+	std::atomic<uint64_t> cycles{0};
+	std::atomic<uint64_t> hw[kHwEvents]{};
+};
+
+struct Stats
+{
+	std::atomic<bool> enabled{false};
+	PhaseStats phases[static_cast<std::size_t>(Phase::kCount)];
+	std::atomic<uint64_t> counters[static_cast<std::size_t>(Counter::kCount)]{};
+	HwCounters hw; // Opened by Enable()
+};
+
+inline Stats &Global()
+{
+	static Stats stats;
+	return stats;
+}
+
+// Starts recording. Call it before starting threads whose hardware events
+// should be counted (see HwCounters).
+inline void Enable()
+{
+	Global().hw.Open();
+	Global().enabled.store(true, std::memory_order_relaxed);
+}
+
+inline bool Enabled()
+{
+	return Global().enabled.load(std::memory_order_relaxed);
+}
+
+inline void Add(Counter counter, uint64_t n)
+{
+	if (Enabled())
+	{
+		Global().counters[static_cast<std::size_t>(counter)].fetch_add(
+			n, std::memory_order_relaxed);
+	}
+}
+
+// Adds the lifetime of the object to 'phase'.
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(Phase phase) : phase(phase), active(Enabled())
+	{
+		if (active)
+		{
+			Global().hw.Read(startHw);
+			start = std::chrono::steady_clock::now();
+			startCycles = Cycles();
+		}
+	}
+
+	~ScopedTimer()
+	{
+		if (!active)
+		{
+			return;
+		}
+		uint64_t cycles = Cycles() - startCycles;
+		uint64_t nanos = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start)
+				.count());
+		uint64_t hw[kHwEvents];
+		Global().hw.Read(hw);
+		PhaseStats &stats = Global().phases[static_cast<std::size_t>(phase)];
+		stats.calls.fetch_add(1, std::memory_order_relaxed);
+		stats.nanos.fetch_add(nanos, std::memory_order_relaxed);
+		stats.cycles.fetch_add(cycles, std::memory_order_relaxed);
+		for (std::size_t e = 0; e < kHwEvents; e++)
+		{
+			// Multiplexing estimates can step back; never record a negative
+			stats.hw[e].fetch_add(hw[e] > startHw[e] ? hw[e] - startHw[e] : 0,
+								  std::memory_order_relaxed);
+		}
+	}
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+	Phase phase;
+	bool active;
+	std::chrono::steady_clock::time_point start;
+	uint64_t startCycles = 0;
+	uint64_t startHw[kHwEvents] = {};
+};
+
+/**
+ * @brief Writes the recorded stats as one JSON object. Phases that never ran
+ * are left out, and so are the hardware events that couldn't be opened. IPC
+ * is instructions per (hardware) cycle.
+ */
+inline void WriteJson(std::ostream &out, const char *solver)
+{
+	Stats &stats = Global();
+	out << "{\"solver\":\"" << solver << "\",\"hw_counters\":[";
+	bool firstEvent = true;
+	for (std::size_t e = 0; e < kHwEvents; e++)
+	{
+		if (stats.hw.Available(static_cast<HwEvent>(e)))
+		{
+			out << (firstEvent ? "" : ",") << '"'
+				<< HwEventName(static_cast<HwEvent>(e)) << '"';
+			firstEvent = false;
+		}
+	}
+	const bool ipc = stats.hw.Available(HwEvent::Cycles) &&
+					 stats.hw.Available(HwEvent::Instructions);
+	out << "],\"phases\":{";
+	bool first = true;
+	for (std::size_t p = 0; p < static_cast<std::size_t>(Phase::kCount); p++)
+	{
+		const PhaseStats &phase = stats.phases[p];
+		uint64_t calls = phase.calls.load(std::memory_order_relaxed);
+		if (calls == 0)
+		{
+			continue;
+		}
+		out << (first ? "" : ",") << '"' << PhaseName(static_cast<Phase>(p))
+			<< "\":{\"calls\":" << calls << ",\"wall_ns\":"
+			<< phase.nanos.load(std::memory_order_relaxed)
+			<< ",\"cycles\":" << phase.cycles.load(std::memory_order_relaxed);
+		for (std::size_t e = 0; e < kHwEvents; e++)
+		{
+			if (stats.hw.Available(static_cast<HwEvent>(e)))
+			{
+				out << ",\"hw_" << HwEventName(static_cast<HwEvent>(e))
+					<< "\":" << phase.hw[e].load(std::memory_order_relaxed);
+			}
+		}
+		if (ipc)
+		{
+			uint64_t cycles = phase.hw[static_cast<std::size_t>(HwEvent::Cycles)]
+								  .load(std::memory_order_relaxed);
+			uint64_t instructions =
+				phase.hw[static_cast<std::size_t>(HwEvent::Instructions)].load(
+					std::memory_order_relaxed);
+			out << ",\"ipc\":"
+				<< (cycles ? double(instructions) / double(cycles) : 0.0);
+		}
+		out << '}';
+		first = false;
+	}
+	out << "},\"counters\":{";
+	for (std::size_t c = 0; c < static_cast<std::size_t>(Counter::kCount); c++)
+	{
+		out << (c ? "," : "") << '"' << CounterName(static_cast<Counter>(c))
+			<< "\":" << stats.counters[c].load(std::memory_order_relaxed);
+	}
+	out << "}}" << std::endl;
+}
+
+// Prints the stats to stderr when it goes out of scope, if profiling is on.
+class JsonOnExit
+{
+public:
+	explicit JsonOnExit(const char *solver) : solver(solver) {}
+	~JsonOnExit()
+	{
+		if (Enabled())
+		{
+			WriteJson(std::cerr, solver);
+		}
+	}
+
+private:
+	const char *solver;
+};
+} // namespace profile
+
+#define AOC_PROFILE_CONCAT2(a, b) a##b
+#define AOC_PROFILE_CONCAT(a, b) AOC_PROFILE_CONCAT2(a, b)
+#define AOC_PROFILE_SCOPE(phase)                                            \
+	::profile::ScopedTimer AOC_PROFILE_CONCAT(aocProfileScope, __LINE__)( \
+		::profile::Phase::phase)
+// 'n' is only evaluated while profiling is enabled.
+#define AOC_PROFILE_COUNT(counter, n)                                      \
+	do                                                                     \
+	{                                                                      \
+		if (::profile::Enabled())                                          \
+		{                                                                  \
+			::profile::Add(::profile::Counter::counter,                    \
+						   static_cast<uint64_t>(n));                      \
+		}                                                                  \
+	} while (0)
+
+#define AOC_PROFILE_REPORT(solver) \
+	::profile::JsonOnExit AOC_PROFILE_CONCAT(aocProfileReport, __LINE__)(solver)
+
+// Replaces global operator new/delete, plain and over-aligned (e.g. the
+// alignas(64) slots of WorkStealingPool::ParallelSum), to count allocations.
+// Expand it once per program, in the translation unit that defines main().
+// The deletes are kept out of line so GCC doesn't pair an inlined free()
+// with the operator new call and warn about a mismatch.
+#define AOC_PROFILE_ALLOCATION_HOOK()                                       \
+	void *operator new(std::size_t size)                                    \
+	{                                                                       \
+		AOC_PROFILE_COUNT(Allocations, 1);                                  \
+		if (void *p = std::malloc(size ? size : 1))                         \
+		{                                                                   \
+			return p;                                                       \
+		}                                                                   \
+		throw std::bad_alloc();                                             \
+	}                                                                       \
+	__attribute__((noinline)) void operator delete(void *p) noexcept       \
+	{                                                                       \
+		std::free(p);                                                       \
+	}                                                                       \
+	__attribute__((noinline)) void operator delete(void *p,                \
+												   std::size_t) noexcept    \
+	{                                                                       \
+		std::free(p);                                                       \
+	}                                                                       \
+	void *operator new(std::size_t size, std::align_val_t align)            \
+	{                                                                       \
+		AOC_PROFILE_COUNT(Allocations, 1);                                  \
+		std::size_t a = static_cast<std::size_t>(align);                    \
+		/* aligned_alloc wants a non-zero multiple of the alignment */     \
+		std::size_t rounded = size ? (size + a - 1) / a * a : a;            \
+		if (void *p = std::aligned_alloc(a, rounded))                       \
+		{                                                                   \
+			return p;                                                       \
+		}                                                                   \
+		throw std::bad_alloc();                                             \
+	}                                                                       \
+	__attribute__((noinline)) void operator delete(                         \
+		void *p, std::align_val_t) noexcept                                 \
+	{                                                                       \
+		std::free(p);                                                       \
+	}                                                                       \
+	__attribute__((noinline)) void operator delete(                         \
+		void *p, std::size_t, std::align_val_t) noexcept                    \
+	{                                                                       \
+		std::free(p);                                                       \
+	}
+
+#else // !AOC_PROFILE
+
+#define AOC_PROFILE_SCOPE(phase)
+#define AOC_PROFILE_COUNT(counter, n)
+#define AOC_PROFILE_ALLOCATION_HOOK()
+#define AOC_PROFILE_REPORT(solver)
+
+#endif // AOC_PROFILE
+
+#endif // AOC_PROFILE_H
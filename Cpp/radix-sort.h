@@ -0,0 +1,380 @@
+#ifndef AOC_RADIX_SORT_H
+#define AOC_RADIX_SORT_H
+
+#include <algorithm>   // For std::sort, std::minmax_element
+#include <cstddef>	   // For std::size_t
+#include <cstdint>	   // For int32_t, uint32_t
+#include <string_view> // For std::string_view
+#include <utility>	   // For std::swap
+#include <vector>	   // For std::vector
+
+#include "thread-pool.h" // For WorkStealingPool
+
+/**
+ * @brief How Day 1 sorts its columns. Auto picks between the two from the
+ * column's size and value range.
+ */
+enum class SortBackend
+{
+	Auto,
+	Std,
+	Radix,
+};
+
+namespace radix_sort_detail
+{
+constexpr unsigned kDigitBits = 11;
+constexpr std::size_t kBuckets = std::size_t(1) << kDigitBits;
+constexpr uint32_t kDigitMask = kBuckets - 1;
+
+// Below this, std::sort beats zeroing and scanning 2048-entry histograms.
+constexpr std::size_t kMinRadixSize = 4096;
+// Below this, three-pass (full 32-bit range) radix sorts lose to std::sort.
+constexpr std::size_t kMinWideRadixSize = std::size_t(1) << 16;
+// Below this, the parallel passes cost more in synchronisation than they save.
+constexpr std::size_t kMinParallelSize = std::size_t(1) << 20;
+
+// Number of 11-bit digits needed once the minimum has been subtracted.
+inline unsigned PassesForRange(uint32_t range)
+{
+	unsigned bits = range == 0 ? 0 : 32 - __builtin_clz(range);
+	return (bits + kDigitBits - 1) / kDigitBits;
+}
+
+// Calls fn(job, begin, end) over [0, sizes[job]) for every job, each cut into
+// one block per pool thread (one block without a pool). All blocks of all
+// jobs share one ParallelFor, so several columns are processed at once.
+template <typename Fn>
+void ForEachBlock(const std::size_t *sizes, std::size_t jobs,
+				  WorkStealingPool *pool, Fn &&fn)
+{
+	const std::size_t blocks = pool ? pool->Size() : 1;
+	auto run = [&](std::size_t task)
+	{
+		std::size_t job = task / blocks, block = task % blocks;
+		std::size_t grain = (sizes[job] + blocks - 1) / blocks;
+		std::size_t begin = std::min(sizes[job], block * grain);
+		std::size_t end = std::min(sizes[job], begin + grain);
+		fn(job, block, begin, end);
+	};
+	if (!pool)
+	{
+		for (std::size_t task = 0; task < jobs; task++)
+		{
+			run(task);
+		}
+		return;
+	}
+	pool->ParallelFor(jobs * blocks, 1,
+					  [&](std::size_t begin, std::size_t end, std::size_t)
+					  {
+						  for (std::size_t task = begin; task < end; task++)
+						  {
+							  run(task);
+						  }
+					  });
+}
+
+// One column's digit pass: its biased keys go from 'src' to 'dst'.
+struct PassJob
+{
+	const uint32_t *src;
+	uint32_t *dst;
+	std::size_t n;
+	unsigned shift;
+};
+
+// One stable counting pass for each job, all jobs at once, using
+// per-thread histograms when a pool is given.
+inline void ScatterPasses(const std::vector<PassJob> &jobs,
+						  WorkStealingPool *pool)
+{
+	const std::size_t blocks = pool ? pool->Size() : 1;
+	std::vector<std::size_t> sizes;
+	for (const PassJob &job : jobs)
+	{
+		sizes.push_back(job.n);
+	}
+	// counts[(j * blocks + b) * kBuckets + d]: keys of job j with digit d in
+	// block b
+	std::vector<std::size_t> counts(jobs.size() * blocks * kBuckets, 0);
+
+	ForEachBlock(sizes.data(), jobs.size(), pool,
+				 [&](std::size_t j, std::size_t block, std::size_t begin,
+					 std::size_t end)
+				 {
+					 const PassJob &job = jobs[j];
+					 std::size_t *count =
+						 counts.data() + (j * blocks + block) * kBuckets;
+					 for (std::size_t i = begin; i < end; i++)
+					 {
+						 count[(job.src[i] >> job.shift) & kDigitMask]++;
+					 }
+				 });
+
+	// Exclusive prefix over (digit, block) so each block scatters into its
+	// own slice of every bucket and the pass stays stable.
+	for (std::size_t j = 0; j < jobs.size(); j++)
+	{
+		std::size_t *count = counts.data() + j * blocks * kBuckets;
+		std::size_t offset = 0;
+		for (std::size_t d = 0; d < kBuckets; d++)
+		{
+			for (std::size_t b = 0; b < blocks; b++)
+			{
+				std::size_t c = count[b * kBuckets + d];
+				count[b * kBuckets + d] = offset;
+				offset += c;
+			}
+		}
+	}
+
+	ForEachBlock(sizes.data(), jobs.size(), pool,
+				 [&](std::size_t j, std::size_t block, std::size_t begin,
+					 std::size_t end)
+				 {
+					 const PassJob &job = jobs[j];
+					 std::size_t *next =
+						 counts.data() + (j * blocks + block) * kBuckets;
+					 for (std::size_t i = begin; i < end; i++)
+					 {
+						 job.dst[next[(job.src[i] >> job.shift) & kDigitMask]++] =
+							 job.src[i];
+					 }
+				 });
+}
+} // namespace radix_sort_detail
+
+/**
+ * @brief LSD radix sort of 'count' columns at once, with 11-bit digits.
+ * Keys are biased by their column's minimum, so only the digits that actually
+ * vary are sorted: a column of 5-digit IDs (range < 2^17) takes two passes,
+ * and the worst case is three. With a pool and enough keys, every step (the
+ * min/max scan, biasing, each pass's histograms and scatter) runs the blocks
+ * of all columns in one ParallelFor: the columns sort concurrently and each
+ * is still split across every thread.
+ */
+inline void RadixSortColumns(
+	std::vector<int32_t> *const *columns, std::size_t count,
+	WorkStealingPool *pool = nullptr,
+	std::size_t minParallel = radix_sort_detail::kMinParallelSize)
+{
+	using namespace radix_sort_detail;
+	std::size_t total = 0;
+	std::vector<std::size_t> sizes;
+	for (std::size_t c = 0; c < count; c++)
+	{
+		sizes.push_back(columns[c]->size());
+		total += sizes.back();
+	}
+	if (total < minParallel || (pool && pool->Size() == 1))
+	{
+		pool = nullptr;
+	}
+	const std::size_t blocks = pool ? pool->Size() : 1;
+
+	// Signed and unsigned variants may alias, so sort the storage in place
+	// as biased unsigned keys, ping-ponging with one scratch buffer each.
+	auto keys = [&](std::size_t c)
+	{ return reinterpret_cast<uint32_t *>(columns[c]->data()); };
+
+	// Per-block minimum and maximum, then per column
+	std::vector<int32_t> blockLo(count * blocks, INT32_MAX);
+	std::vector<int32_t> blockHi(count * blocks, INT32_MIN);
+	ForEachBlock(sizes.data(), count, pool,
+				 [&](std::size_t c, std::size_t block, std::size_t begin,
+					 std::size_t end)
+				 {
+					 const int32_t *k = columns[c]->data();
+					 int32_t lo = INT32_MAX, hi = INT32_MIN;
+					 for (std::size_t i = begin; i < end; i++)
+					 {
+						 lo = k[i] < lo ? k[i] : lo;
+						 hi = k[i] > hi ? k[i] : hi;
+					 }
+					 blockLo[c * blocks + block] = lo;
+					 blockHi[c * blocks + block] = hi;
+				 });
+	std::vector<uint32_t> bias(count);
+	std::vector<unsigned> passes(count, 0);
+	unsigned maxPasses = 0;
+	for (std::size_t c = 0; c < count; c++)
+	{
+		if (sizes[c] < 2)
+		{
+			continue;
+		}
+		int32_t lo = *std::min_element(blockLo.begin() + c * blocks,
+									   blockLo.begin() + (c + 1) * blocks);
+		int32_t hi = *std::max_element(blockHi.begin() + c * blocks,
+									   blockHi.begin() + (c + 1) * blocks);
+		bias[c] = static_cast<uint32_t>(lo);
+		// Zero passes: all keys equal, nothing to do
+		passes[c] = PassesForRange(static_cast<uint32_t>(hi) - bias[c]);
+		maxPasses = std::max(maxPasses, passes[c]);
+	}
+	if (maxPasses == 0)
+	{
+		return;
+	}
+
+	ForEachBlock(sizes.data(), count, pool,
+				 [&](std::size_t c, std::size_t, std::size_t begin,
+					 std::size_t end)
+				 {
+					 if (passes[c] == 0)
+					 {
+						 return;
+					 }
+					 uint32_t *k = keys(c);
+					 for (std::size_t i = begin; i < end; i++)
+					 {
+						 k[i] -= bias[c];
+					 }
+				 });
+
+	std::vector<std::vector<uint32_t>> scratch(count);
+	std::vector<uint32_t *> src(count), dst(count);
+	for (std::size_t c = 0; c < count; c++)
+	{
+		if (passes[c] > 0)
+		{
+			scratch[c].resize(sizes[c]);
+		}
+		src[c] = keys(c);
+		dst[c] = scratch[c].data();
+	}
+	std::vector<PassJob> jobs;
+	for (unsigned pass = 0; pass < maxPasses; pass++)
+	{
+		jobs.clear();
+		for (std::size_t c = 0; c < count; c++)
+		{
+			if (pass < passes[c])
+			{
+				jobs.push_back({src[c], dst[c], sizes[c], pass * kDigitBits});
+				std::swap(src[c], dst[c]);
+			}
+		}
+		ScatterPasses(jobs, pool);
+	}
+
+	// Unbias; odd pass counts leave the result in the scratch buffer, so
+	// this is also the copy back.
+	ForEachBlock(sizes.data(), count, pool,
+				 [&](std::size_t c, std::size_t, std::size_t begin,
+					 std::size_t end)
+				 {
+					 if (passes[c] == 0)
+					 {
+						 return;
+					 }
+					 uint32_t *k = keys(c);
+					 for (std::size_t i = begin; i < end; i++)
+					 {
+						 k[i] = src[c][i] + bias[c];
+					 }
+				 });
+}
+
+/**
+ * @brief LSD radix sort of one column (see RadixSortColumns).
+ */
+inline void RadixSort(std::vector<int32_t> &keys,
+					  WorkStealingPool *pool = nullptr)
+{
+	std::vector<int32_t> *columns[] = {&keys};
+	RadixSortColumns(columns, 1, pool);
+}
+
+/**
+ * @brief Sorts 'count' Day 1 columns with the requested backend. Auto picks
+ * per column: the radix sort unless the column is too small to amortise its
+ * histograms, or its value range needs all three passes and the column is
+ * still modest. The radix-sorted columns share their passes
+ * (RadixSortColumns); with a pool, the std::sort ones run side by side, one
+ * per thread. Radix sorts of fewer than 'minParallel' keys in all stay on
+ * the calling thread.
+ */
+inline void SortColumns(
+	std::vector<int32_t> *const *columns, std::size_t count, SortBackend backend,
+	WorkStealingPool *pool = nullptr,
+	std::size_t minParallel = radix_sort_detail::kMinParallelSize)
+{
+	using namespace radix_sort_detail;
+	std::vector<std::vector<int32_t> *> radix, others;
+	for (std::size_t c = 0; c < count; c++)
+	{
+		std::vector<int32_t> &keys = *columns[c];
+		SortBackend chosen = backend;
+		if (chosen == SortBackend::Auto)
+		{
+			chosen = SortBackend::Std;
+			if (keys.size() >= kMinRadixSize)
+			{
+				auto [lo, hi] = std::minmax_element(keys.begin(), keys.end());
+				unsigned passes = PassesForRange(static_cast<uint32_t>(*hi) -
+												 static_cast<uint32_t>(*lo));
+				if (passes < 3 || keys.size() >= kMinWideRadixSize)
+				{
+					chosen = SortBackend::Radix;
+				}
+			}
+		}
+		(chosen == SortBackend::Radix ? radix : others).push_back(&keys);
+	}
+	if (!radix.empty())
+	{
+		RadixSortColumns(radix.data(), radix.size(), pool, minParallel);
+	}
+	auto sortRange = [&](std::size_t begin, std::size_t end, std::size_t)
+	{
+		for (std::size_t c = begin; c < end; c++)
+		{
+			std::sort(others[c]->begin(), others[c]->end());
+		}
+	};
+	if (pool && others.size() > 1)
+	{
+		pool->ParallelFor(others.size(), 1, sortRange);
+	}
+	else
+	{
+		sortRange(0, others.size(), 0);
+	}
+}
+
+// Sorts one Day 1 column with the requested backend (see SortColumns).
+inline void SortColumn(std::vector<int32_t> &keys, SortBackend backend,
+					   WorkStealingPool *pool = nullptr)
+{
+	std::vector<int32_t> *columns[] = {&keys};
+	SortColumns(columns, 1, backend, pool);
+}
+
+/**
+ * @brief Parses a sort backend name ("auto", "std", "radix").
+ * @return false if the name is not recognised.
+ */
+inline bool SortBackendFromName(std::string_view name, SortBackend &backend)
+{
+	if (name == "auto")
+	{
+		backend = SortBackend::Auto;
+	}
+	else if (name == "std")
+	{
+		backend = SortBackend::Std;
+	}
+	else if (name == "radix")
+	{
+		backend = SortBackend::Radix;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+#endif // AOC_RADIX_SORT_H
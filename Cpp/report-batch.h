@@ -0,0 +1,296 @@
+#ifndef AOC_REPORT_BATCH_H
+#define AOC_REPORT_BATCH_H
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For int32_t, uint32_t, uint64_t
+#include <vector>  // For std::vector
+
+#include "report-table.h"  // For FlatReports
+#include "safety-kernel.h" // For IsSafeReport
+#include "simd-target.h"   // For AOC_TARGET, AOC_X86
+
+/**
+ * @brief Bitset with one bit per report: bit r is set if report r is safe.
+ */
+class SafeMask
+{
+public:
+	void Reset(std::size_t count)
+	{
+		size = count;
+		words.assign((count + 63) / 64, 0);
+	}
+	void Set(std::size_t r) { words[r / 64] |= 1ULL << (r % 64); }
+	bool Test(std::size_t r) const { return (words[r / 64] >> (r % 64)) & 1; }
+	std::size_t Size() const { return size; }
+	bool Empty() const { return size == 0; }
+
+	std::size_t CountSet() const
+	{
+		std::size_t total = 0;
+		for (uint64_t w : words)
+		{
+			total += static_cast<std::size_t>(__builtin_popcountll(w));
+		}
+		return total;
+	}
+
+	// Set bits among reports [begin, end).
+	std::size_t CountSet(std::size_t begin, std::size_t end) const
+	{
+		std::size_t total = 0;
+		for (std::size_t w = begin / 64; w * 64 < end; w++)
+		{
+			uint64_t bits = words[w];
+			if (w == begin / 64)
+			{
+				bits &= ~0ULL << (begin % 64);
+			}
+			if ((w + 1) * 64 > end)
+			{
+				bits &= ~0ULL >> (64 - end % 64);
+			}
+			total += static_cast<std::size_t>(__builtin_popcountll(bits));
+		}
+		return total;
+	}
+
+private:
+	std::vector<uint64_t> words;
+	std::size_t size = 0;
+};
+
+namespace report_batch_detail
+{
+/**
+ * @brief Lockstep check of L equal-length reports stored structure-of-arrays:
+ * level j of lane k is soa[j * L + k]. Each lane gets its own trend from its
+ * first step. Returns bit k set if lane k is safe.
+ */
+template <std::size_t L>
+inline uint32_t CheckBatchScalar(const int32_t *soa, std::size_t n)
+{
+	uint32_t mask = 0;
+	for (std::size_t k = 0; k < L; k++)
+	{
+		int dir = soa[k] < soa[L + k] ? 1 : -1;
+		unsigned bad = 0;
+		for (std::size_t j = 0; j + 1 < n; j++)
+		{
+			int step = (soa[(j + 1) * L + k] - soa[j * L + k]) * dir;
+			bad |= static_cast<unsigned>(step - 1) > 2u;
+		}
+		mask |= static_cast<uint32_t>(bad == 0) << k;
+	}
+	return mask;
+}
+
+#if AOC_X86
+// 8 reports per batch: one __m256i holds the same level of every lane.
+AOC_TARGET("avx2")
+inline uint32_t CheckBatchAvx2(const int32_t *soa, std::size_t n)
+{
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i four = _mm256_set1_epi32(4);
+	__m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(soa));
+	__m256i next =
+		_mm256_loadu_si256(reinterpret_cast<const __m256i *>(soa + 8));
+	// dir = +1 where the first step increases, -1 otherwise (as IsSafeReport)
+	__m256i dir = _mm256_blendv_epi8(_mm256_set1_epi32(-1), one,
+							 _mm256_cmpgt_epi32(next, prev));
+	__m256i ok = _mm256_set1_epi32(-1);
+	for (std::size_t j = 1; j < n; j++)
+	{
+		next = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i *>(soa + j * 8));
+		// _mm256_sign_epi32 negates the decreasing lanes' differences, so one
+		// 1 <= step <= 3 range test serves both trends.
+		__m256i step = _mm256_sign_epi32(_mm256_sub_epi32(next, prev), dir);
+		ok = _mm256_and_si256(
+			ok, _mm256_and_si256(_mm256_cmpgt_epi32(step, _mm256_setzero_si256()),
+								 _mm256_cmpgt_epi32(four, step)));
+		prev = next;
+	}
+	return static_cast<uint32_t>(
+		_mm256_movemask_ps(_mm256_castsi256_ps(ok)));
+}
+
+// 16 reports per batch, with per-lane predicates in mask registers.
+AOC_TARGET("avx512f")
+inline uint32_t CheckBatchAvx512(const int32_t *soa, std::size_t n)
+{
+	const __m512i zero = _mm512_setzero_si512();
+	const __m512i four = _mm512_set1_epi32(4);
+	__m512i prev = _mm512_loadu_si512(soa);
+	__m512i next = _mm512_loadu_si512(soa + 16);
+	__mmask16 decreasing = _mm512_cmple_epi32_mask(next, prev);
+	__mmask16 ok = 0xFFFF;
+	for (std::size_t j = 1; j < n; j++)
+	{
+		next = _mm512_loadu_si512(soa + j * 16);
+		__m512i step = _mm512_sub_epi32(next, prev);
+		step = _mm512_mask_sub_epi32(step, decreasing, zero, step);
+		ok = _mm512_mask_cmpgt_epi32_mask(ok, step, zero);
+		ok = _mm512_mask_cmplt_epi32_mask(ok, step, four);
+		prev = next;
+	}
+	return static_cast<uint32_t>(ok);
+}
+#endif // AOC_X86
+
+// Lane count and kernel for the widest batch the running CPU supports.
+struct BatchKernel
+{
+	std::size_t lanes;
+	uint32_t (*check)(const int32_t *soa, std::size_t n);
+};
+
+inline BatchKernel SelectBatchKernel()
+{
+#if AOC_X86
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return {16, CheckBatchAvx512};
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return {8, CheckBatchAvx2};
+	}
+#endif
+	return {8, CheckBatchScalar<8>};
+}
+} // namespace report_batch_detail
+
+/**
+ * @brief Classifies reports [begin, end) of 'reports' in SIMD batches and sets
+ * the bits of the safe ones in 'mask' (bit r = report r is safe, by the same
+ * rule as IsSafeReport). 'mask' must already be sized for the whole table.
+ * Reports are bucketed by length with a counting sort over their indices;
+ * each full group of 8 (AVX2) or 16 (AVX-512) equal-length reports is
+ * transposed into a structure-of-arrays buffer and checked in lockstep, one
+ * vector compare per level. Leftover reports in each bucket use the scalar
+ * kernel. Ranges starting on a multiple of 64 touch disjoint mask words, so
+ * separate threads may classify separate ranges.
+ */
+template <typename T>
+void ClassifyBatchedRange(const FlatReports<T> &reports, std::size_t begin,
+						  std::size_t end, SafeMask &mask)
+{
+	const std::size_t count = end - begin;
+	if (count == 0)
+	{
+		return;
+	}
+
+	// The batch kernels subtract in 32-bit lanes. An int32_t table whose
+	// levels reach past +-2^30 could overflow them, so it is checked with
+	// the scalar kernel, which widens its steps.
+	if constexpr (sizeof(T) >= sizeof(int32_t))
+	{
+		constexpr T kLaneLimit = T(1) << 30;
+		bool wide = false;
+		for (std::size_t i = reports.offsets[begin]; i < reports.offsets[end];
+			 i++)
+		{
+			wide |= reports.values[i] < -kLaneLimit ||
+					reports.values[i] >= kLaneLimit;
+		}
+		if (wide)
+		{
+			for (std::size_t r = begin; r < end; r++)
+			{
+				auto report = reports[r];
+				if (IsSafeReport(report.data(), report.size()))
+				{
+					mask.Set(r);
+				}
+			}
+			return;
+		}
+	}
+
+	// Counting sort of report indices by length: 'order' lists every report
+	// grouped by length, bucket n spanning [first[n], first[n + 1]).
+	std::size_t maxLen = 0;
+	for (std::size_t r = begin; r < end; r++)
+	{
+		std::size_t n = reports.offsets[r + 1] - reports.offsets[r];
+		maxLen = n > maxLen ? n : maxLen;
+	}
+	std::vector<std::size_t> first(maxLen + 2, 0);
+	for (std::size_t r = begin; r < end; r++)
+	{
+		first[reports.offsets[r + 1] - reports.offsets[r] + 1]++;
+	}
+	for (std::size_t n = 1; n < first.size(); n++)
+	{
+		first[n] += first[n - 1];
+	}
+	std::vector<std::size_t> order(count);
+	{
+		std::vector<std::size_t> fill(first.begin(), first.end() - 1);
+		for (std::size_t r = begin; r < end; r++)
+		{
+			order[fill[reports.offsets[r + 1] - reports.offsets[r]]++] = r;
+		}
+	}
+
+	const report_batch_detail::BatchKernel kernel =
+		report_batch_detail::SelectBatchKernel();
+	const std::size_t L = kernel.lanes;
+	std::vector<int32_t> soa(maxLen * L);
+
+	for (std::size_t n = 0; n <= maxLen; n++)
+	{
+		std::size_t b = first[n];
+		std::size_t e = first[n + 1];
+		if (n < 2)
+		{
+			// Zero- and one-level reports are vacuously safe
+			for (; b < e; b++)
+			{
+				mask.Set(order[b]);
+			}
+			continue;
+		}
+		for (; b + L <= e; b += L)
+		{
+			// Transpose L reports of length n into level-major order
+			for (std::size_t k = 0; k < L; k++)
+			{
+				const T *levels = reports.values.data() +
+								  reports.offsets[order[b + k]];
+				for (std::size_t j = 0; j < n; j++)
+				{
+					soa[j * L + k] = levels[j];
+				}
+			}
+			uint32_t safe = kernel.check(soa.data(), n);
+			while (safe)
+			{
+				mask.Set(order[b + __builtin_ctz(safe)]);
+				safe &= safe - 1;
+			}
+		}
+		for (; b < e; b++)
+		{
+			auto report = reports[order[b]];
+			if (IsSafeReport(report.data(), report.size()))
+			{
+				mask.Set(order[b]);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Classifies the whole table; see ClassifyBatchedRange.
+ */
+template <typename T>
+void ClassifyBatched(const FlatReports<T> &reports, SafeMask &mask)
+{
+	mask.Reset(reports.Count());
+	ClassifyBatchedRange(reports, 0, reports.Count(), mask);
+}
+
+#endif // AOC_REPORT_BATCH_H
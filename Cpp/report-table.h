@@ -0,0 +1,245 @@
+#ifndef AOC_REPORT_TABLE_H
+#define AOC_REPORT_TABLE_H
+
+#include <cstddef>			// For std::size_t
+#include <cstdint>			// For int8_t, int16_t, int32_t, uint64_t
+#include <initializer_list> // For std::initializer_list
+#include <limits>			// For std::numeric_limits
+#include <type_traits>		// For std::decay_t
+#include <variant>			// For std::variant, std::visit
+#include <vector>			// For std::vector
+
+/**
+ * @brief Non-owning view of one report inside a FlatReports table. Exposes
+ * size() and operator[] so the solvers can treat it like a std::vector.
+ */
+template <typename T>
+struct ReportView
+{
+	const T *values = nullptr;
+	std::size_t length = 0;
+
+	std::size_t size() const { return length; }
+	bool empty() const { return length == 0; }
+	int operator[](std::size_t i) const { return values[i]; }
+	const T *data() const { return values; }
+	const T *begin() const { return values; }
+	const T *end() const { return values + length; }
+};
+
+/**
+ * @brief "Compressed sparse row" storage for a list of variable-length
+ * reports: every level of every report lives in one contiguous 'values'
+ * array, and report r spans [offsets[r], offsets[r + 1]). Two allocations in
+ * total instead of one per report, and a linear scan walks memory in order.
+ * @tparam T The value type; narrower types shrink the table proportionally.
+ */
+template <typename T>
+class FlatReports
+{
+public:
+	using ValueType = T;
+
+	std::vector<T> values;
+	std::vector<uint64_t> offsets{0};
+
+	std::size_t Count() const { return offsets.size() - 1; }
+
+	ReportView<T> operator[](std::size_t r) const
+	{
+		return {values.data() + offsets[r],
+				static_cast<std::size_t>(offsets[r + 1] - offsets[r])};
+	}
+
+	// True if every value in [lo, hi] can be stored as T without loss.
+	static bool Fits(int lo, int hi)
+	{
+		return lo >= std::numeric_limits<T>::min() &&
+			   hi <= std::numeric_limits<T>::max();
+	}
+
+	template <typename Int>
+	void Append(const Int *nums, std::size_t n)
+	{
+		values.insert(values.end(), nums, nums + n);
+		offsets.push_back(values.size());
+	}
+
+	// Appends every report of 'other' (of any width that fits in T).
+	template <typename U>
+	void AppendAll(const FlatReports<U> &other)
+	{
+		uint64_t base = values.size();
+		values.insert(values.end(), other.values.begin(), other.values.end());
+		offsets.reserve(offsets.size() + other.Count());
+		for (std::size_t r = 1; r < other.offsets.size(); r++)
+		{
+			offsets.push_back(base + other.offsets[r]);
+		}
+	}
+
+	std::size_t MemoryBytes() const
+	{
+		return values.capacity() * sizeof(T) +
+			   offsets.capacity() * sizeof(uint64_t);
+	}
+};
+
+/**
+ * @brief A FlatReports table whose value width is chosen from the data: it
+ * starts as int8_t (the puzzle levels are 1-2 digits) and is widened once to
+ * int16_t or int32_t the first time a value doesn't fit.
+ */
+class ReportTable
+{
+public:
+	using Storage = std::variant<FlatReports<int8_t>, FlatReports<int16_t>,
+								 FlatReports<int32_t>>;
+
+	ReportTable() = default;
+
+	// Convenience for small, hand-written data sets.
+	ReportTable(std::initializer_list<std::initializer_list<int>> reports)
+	{
+		for (const auto &report : reports)
+		{
+			AddReport(report.begin(), report.size());
+		}
+	}
+
+	/**
+	 * @brief Appends one report, widening the whole table first if any of its
+	 * values is out of range for the current width.
+	 */
+	void AddReport(const int *nums, std::size_t n)
+	{
+		if (n > 0)
+		{
+			int lo = nums[0], hi = nums[0];
+			for (std::size_t i = 1; i < n; i++)
+			{
+				lo = nums[i] < lo ? nums[i] : lo;
+				hi = nums[i] > hi ? nums[i] : hi;
+			}
+			WidenToFit(lo, hi);
+		}
+		std::visit([&](auto &reports) { reports.Append(nums, n); }, storage);
+	}
+
+	void AddReport(const std::vector<int> &nums)
+	{
+		AddReport(nums.data(), nums.size());
+	}
+
+	/**
+	 * @brief Appends every report of 'other', widening to the wider of the two
+	 * tables first.
+	 */
+	void AppendTable(const ReportTable &other)
+	{
+		if (other.storage.index() > storage.index())
+		{
+			WidenTo(other.storage.index());
+		}
+		std::visit(
+			[&](auto &dst)
+			{
+				std::visit([&](const auto &src) { dst.AppendAll(src); },
+						   other.storage);
+			},
+			storage);
+	}
+
+	/**
+	 * @brief Replaces the contents with reports given as CSR columns (report r
+	 * is values[offsets[r], offsets[r + 1])), taking ownership of both. T
+	 * must be one of the table's value widths.
+	 * @return false, leaving the table empty, if the offsets don't describe
+	 * 'values'.
+	 */
+	template <typename T>
+	bool AssignColumns(std::vector<T> values, std::vector<uint64_t> offsets)
+	{
+		storage = FlatReports<int8_t>();
+		if (offsets.empty() || offsets.front() != 0 ||
+			offsets.back() != values.size())
+		{
+			return false;
+		}
+		for (std::size_t r = 1; r < offsets.size(); r++)
+		{
+			if (offsets[r] < offsets[r - 1])
+			{
+				return false;
+			}
+		}
+		FlatReports<T> reports;
+		reports.values = std::move(values);
+		reports.offsets = std::move(offsets);
+		storage = std::move(reports);
+		return true;
+	}
+
+	std::size_t Count() const
+	{
+		return std::visit([](const auto &reports) { return reports.Count(); },
+						  storage);
+	}
+
+	// Bytes per stored level: 1, 2 or 4.
+	std::size_t ValueWidth() const
+	{
+		return std::visit(
+			[](const auto &reports)
+			{ return sizeof(typename std::decay_t<decltype(reports)>::ValueType); },
+			storage);
+	}
+
+	std::size_t MemoryBytes() const
+	{
+		return std::visit(
+			[](const auto &reports) { return reports.MemoryBytes(); }, storage);
+	}
+
+	/**
+	 * @brief Calls fn(const FlatReports<T> &) with the concrete table, so the
+	 * hot loops are compiled once per width with no per-element dispatch.
+	 */
+	template <typename Fn>
+	decltype(auto) Visit(Fn &&fn) const
+	{
+		return std::visit(fn, storage);
+	}
+
+private:
+	Storage storage;
+
+	void WidenToFit(int lo, int hi)
+	{
+		if (storage.index() == 0 && !FlatReports<int8_t>::Fits(lo, hi))
+		{
+			WidenTo(FlatReports<int16_t>::Fits(lo, hi) ? 1 : 2);
+		}
+		else if (storage.index() == 1 && !FlatReports<int16_t>::Fits(lo, hi))
+		{
+			WidenTo(2);
+		}
+	}
+
+	// Re-encodes the existing values at the width with variant index 'index'.
+	void WidenTo(std::size_t index)
+	{
+		Storage wider = index == 1 ? Storage(FlatReports<int16_t>())
+								   : Storage(FlatReports<int32_t>());
+		std::visit(
+			[&](auto &dst)
+			{
+				std::visit([&](const auto &src) { dst.AppendAll(src); },
+						   storage);
+			},
+			wider);
+		storage = std::move(wider);
+	}
+};
+
+#endif // AOC_REPORT_TABLE_H
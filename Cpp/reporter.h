@@ -0,0 +1,64 @@
+#ifndef AOC_REPORTER_H
+#define AOC_REPORTER_H
+
+#include <charconv>	   // For std::to_chars
+#include <cstdint>	   // For int64_t
+#include <iostream>	   // For std::ostream, std::cout
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view
+
+/**
+ * @brief Collects answer lines in memory and writes them out in one go.
+ * Solvers only return numbers; whoever drives them decides whether and where
+ * to print. Nothing reaches the stream until Flush() (or destruction), and
+ * that is a single write with no per-line std::endl flush.
+ */
+class Reporter
+{
+public:
+	explicit Reporter(std::ostream &out = std::cout) : out(out) {}
+	~Reporter() { Flush(); }
+
+	Reporter(const Reporter &) = delete;
+	Reporter &operator=(const Reporter &) = delete;
+
+	// Appends "Part <part>: <answer>".
+	void Part(int part, int64_t answer)
+	{
+		buffer += "Part ";
+		Append(part);
+		buffer += ": ";
+		Append(answer);
+		buffer += '\n';
+	}
+
+	// Appends a free-form line (headings, blank separators).
+	void Line(std::string_view text)
+	{
+		buffer += text;
+		buffer += '\n';
+	}
+
+	void Flush()
+	{
+		if (!buffer.empty())
+		{
+			out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			out.flush();
+			buffer.clear();
+		}
+	}
+
+private:
+	std::ostream &out;
+	std::string buffer;
+
+	void Append(int64_t value)
+	{
+		char digits[24];
+		auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+		buffer.append(digits, end);
+	}
+};
+
+#endif // AOC_REPORTER_H
@@ -0,0 +1,746 @@
+// Runs any subset of days and parts from one process.
+//
+// Build (from Cpp/):
+//   g++ -std=c++17 -O2 -pthread -DAOC_RUNNER runner.cpp day-01.cpp day-02.cpp
+//
+// Add -DAOC_ZLIB -lz and/or -DAOC_ZSTD -lzstd to read gzip / zstd inputs
+// (compressed-input.h).
+//
+// Add -DAOC_PROFILE for --profile: phase timings and hardware counters,
+// with the frame-pointer build for perf and flame graphs given in profile.h.
+//
+// Each day-XX.cpp still builds on its own; with AOC_RUNNER defined it drops its
+// main() and only contributes its MakeDayN() factory.
+//
+// Batches: --days 1 --input 'shards/*.txt' --jobs 8 solves every matching
+// file (see input-set.h) on a pool of 8 threads, prints each file's answers
+// in input order, then the answers summed over all files.
+//
+// Shards: with --shards the inputs are instead pieces of one dataset. Each is
+// mapped to a PartialResult (IDay::Map, see partial-result.h) and the
+// partials are combined into the dataset's answers (IDay::Combine).
+//   --workers 4                   maps in 4 processes of this runner
+//   --launcher 'ssh node1' ...    starts them through these commands in turn
+//                                 (the nodes must see the same paths)
+//   --map                         a worker: prints each input's partial
+//   --combine 'parts/*.txt'       combines partials saved from --map runs
+//
+// Self-checks: --self-check 200 runs each selected day's IDay::SelfCheck on
+// its default input and on 200 rounds of generated adversarial inputs
+// (synthetic-input.h), comparing every fast path with the reference code.
+// The same checks make a libFuzzer target, built without main():
+//   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined
+//       -DAOC_LIBFUZZER -DAOC_RUNNER runner.cpp day-01.cpp day-02.cpp
+
+#include <charconv>	   // For std::from_chars
+#include <cstddef>	   // For std::size_t
+#include <cstdint>	   // For int64_t
+#include <cstdio>	   // For std::FILE, std::fread
+#include <cstdlib>	   // For std::abort (fuzzer failures)
+#include <fstream>	   // For std::ifstream (--combine)
+#include <iostream>	   // For std::cout, std::cerr
+#include <memory>	   // For std::unique_ptr
+#include <sstream>	   // For std::istringstream (worker output)
+#include <string>	   // For std::string
+#include <string_view> // For std::string_view
+#include <thread>	   // For std::thread
+#include <vector>	   // For std::vector
+
+#include "IDay.h"		 // For IDay
+#include "input-set.h"	 // For ExpandInputs (--input paths and globs)
+#include "profile.h"	 // For AOC_PROFILE_REPORT (--profile builds)
+#include "reporter.h"	 // For Reporter (per-day answer buffers)
+#include "synthetic-input.h" // For AdversarialText (--self-check)
+#include "thread-pool.h" // For WorkStealingPool (--jobs)
+
+#if __has_include(<unistd.h>)
+#include <stdio.h> // For popen, pclose
+#define AOC_HAVE_POPEN 1
+#else
+#define AOC_HAVE_POPEN 0
+#endif
+
+// Factories defined by the day files.
+std::unique_ptr<IDay> MakeDay1();
+std::unique_ptr<IDay> MakeDay2();
+
+// One entry per solved day: its number, default input and factory.
+struct DayEntry
+{
+	int day;
+	const char *input;
+	std::unique_ptr<IDay> (*make)();
+};
+
+// The registry. Adding a day means adding its factory above and a row here.
+constexpr DayEntry kDays[] = {
+	{1, "../inputs/input-01.txt", &MakeDay1},
+	{2, "../inputs/input-02.txt", &MakeDay2},
+};
+
+AOC_PROFILE_ALLOCATION_HOOK()
+
+// Which days and parts to run.
+struct RunnerOptions
+{
+	std::vector<int> days; // Empty runs every registered day
+	bool partOne = true;
+	bool partTwo = true;
+	bool concurrent = false; // Solve the days at once, one thread each
+	LoadOptions load;		 // How each input file is read
+	// Files, globs and @lists to solve instead of the day's default input
+	std::vector<std::string> inputs;
+	std::size_t jobs = 1; // Threads solving inputs at once (0 = all cores)
+	// Sharded runs: combine the inputs' partial results into one answer
+	bool shards = false;
+	std::size_t workers = 0;			// Worker processes (0 maps in-process)
+	std::vector<std::string> launchers; // Command prefixes for the workers
+	bool map = false;					// Print partials instead of answers
+	std::vector<std::string> combine;	// Files of partials to combine
+	// The load flags as given, passed on to worker processes
+	std::vector<std::string> loadArgs;
+	// Rounds of generated inputs to self-check each day on (0: solve)
+	std::size_t selfChecks = 0;
+};
+
+// One input to solve, and what came of it.
+struct RunTask
+{
+	const DayEntry *entry;
+	std::string input;
+	bool ok = false;
+	int64_t part1 = 0;
+	int64_t part2 = 0;
+	PartialResult partial{}; // Sharded runs only
+};
+
+// Parses a comma-separated list of small integers ("1,2").
+static bool ParseList(std::string_view text, std::vector<int> &values)
+{
+	values.clear();
+	while (!text.empty())
+	{
+		std::size_t comma = text.find(',');
+		std::string_view item = text.substr(0, comma);
+		int value = 0;
+		if (item.empty() ||
+			std::from_chars(item.data(), item.data() + item.size(), value).ec !=
+				std::errc())
+		{
+			return false;
+		}
+		values.push_back(value);
+		text.remove_prefix(comma == std::string_view::npos ? text.size()
+														   : comma + 1);
+	}
+	return !values.empty();
+}
+
+// Loads the task's input into a fresh solver (as options.load asks), then
+// runs the requested parts, collecting the answers in 'reporter'. Leaves
+// task.ok false on I/O errors.
+static void RunDay(RunTask &task, const RunnerOptions &options, bool named,
+				   Reporter &reporter)
+{
+	reporter.Line("Day " + std::to_string(task.entry->day) +
+				  (named ? ": " + task.input : std::string()));
+	std::unique_ptr<IDay> solver = task.entry->make();
+	if (!solver->LoadFile(task.input, options.load))
+	{
+		reporter.Line("ERROR: Unable to load " + task.input);
+		return;
+	}
+	if (options.partOne && options.partTwo)
+	{
+		// Both parts through Solve, so days can share work between them
+		if (!solver->Solve(task.part1, task.part2))
+		{
+			reporter.Line("ERROR: Unable to solve " + task.input);
+			return;
+		}
+		reporter.Part(1, task.part1);
+		reporter.Part(2, task.part2);
+	}
+	else if (options.partOne)
+	{
+		task.part1 = solver->PartOne();
+		reporter.Part(1, task.part1);
+	}
+	else if (options.partTwo)
+	{
+		task.part2 = solver->PartTwo();
+		reporter.Part(2, task.part2);
+	}
+	task.ok = true;
+}
+
+// Sharded runs: loads the task's input and maps it to its partial result.
+static void MapShard(RunTask &task, const RunnerOptions &options)
+{
+	std::unique_ptr<IDay> solver = task.entry->make();
+	if (!solver->LoadFile(task.input, options.load))
+	{
+		task.partial.ok = false;
+		return;
+	}
+	task.partial = solver->Map();
+	task.ok = task.partial.ok;
+}
+
+// Reads every partial in 'in'. Reports and returns false on a malformed or
+// failed record.
+static bool ReadPartials(std::istream &in, const std::string &source,
+						 std::vector<PartialResult> &partials)
+{
+	PartialResult partial;
+	while (partial.Read(in))
+	{
+		if (!partial.ok)
+		{
+			std::cerr << "ERROR: A shard failed in " << source << std::endl;
+			return false;
+		}
+		partials.push_back(std::move(partial));
+		partial = PartialResult();
+	}
+	if (!in.eof())
+	{
+		std::cerr << "ERROR: Malformed partial result from " << source
+				  << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#if AOC_HAVE_POPEN
+// Quotes 'text' as one word for /bin/sh.
+static std::string ShellQuote(const std::string &text)
+{
+	std::string quoted = "'";
+	for (char c : text)
+	{
+		quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+	}
+	return quoted + "'";
+}
+
+// Deals the tasks' inputs round-robin onto options.workers processes of this
+// runner in --map mode, started through the launchers in turn, and collects
+// their partials. Each worker's pipe is drained on its own thread, so none
+// stalls on a full pipe while another is being read. Paths go on the
+// command line, so a worker's share must fit within the argument limit.
+static bool RunWorkers(const std::vector<RunTask> &tasks,
+					   const RunnerOptions &options, const std::string &self,
+					   std::vector<PartialResult> &partials)
+{
+	struct Worker
+	{
+		std::string command;
+		std::size_t shards = 0;
+		std::string output;
+		int status = -1;
+	};
+	std::vector<Worker> workers(std::min(options.workers, tasks.size()));
+	for (std::size_t w = 0; w < workers.size(); w++)
+	{
+		Worker &worker = workers[w];
+		if (!options.launchers.empty())
+		{
+			worker.command =
+				options.launchers[w % options.launchers.size()] + " ";
+		}
+		worker.command += ShellQuote(self) + " --days " +
+						  std::to_string(tasks[0].entry->day) +
+						  " --map --jobs " + std::to_string(options.jobs);
+		for (const std::string &arg : options.loadArgs)
+		{
+			worker.command += " " + ShellQuote(arg);
+		}
+		for (std::size_t t = w; t < tasks.size(); t += workers.size())
+		{
+			worker.command += " --input " + ShellQuote(tasks[t].input);
+			worker.shards++;
+		}
+	}
+
+	std::vector<std::thread> threads;
+	for (Worker &worker : workers)
+	{
+		threads.emplace_back(
+			[&worker]
+			{
+				std::FILE *pipe = popen(worker.command.c_str(), "r");
+				if (!pipe)
+				{
+					return;
+				}
+				char buffer[1 << 16];
+				std::size_t n;
+				while ((n = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+				{
+					worker.output.append(buffer, n);
+				}
+				worker.status = pclose(pipe);
+			});
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	bool ok = true;
+	for (std::size_t w = 0; w < workers.size(); w++)
+	{
+		const Worker &worker = workers[w];
+		const std::string source = "worker " + std::to_string(w + 1);
+		std::istringstream in(worker.output);
+		std::size_t before = partials.size();
+		if (worker.status != 0)
+		{
+			std::cerr << "ERROR: " << source << " failed: " << worker.command
+					  << std::endl;
+			ok = false;
+		}
+		else if (!ReadPartials(in, source, partials) ||
+				 partials.size() - before != worker.shards)
+		{
+			std::cerr << "ERROR: " << source << " returned "
+					  << partials.size() - before << " of " << worker.shards
+					  << " partial results" << std::endl;
+			ok = false;
+		}
+	}
+	return ok;
+}
+#endif
+
+/**
+ * @brief Self-checks one day on its default input, when it can be read, and
+ * on 'rounds' rounds of generated inputs: two-column and free-form text of
+ * varying length. Disagreements are described on std::cerr.
+ * @param checked Incremented once per input checked.
+ * @return The number of inputs that failed.
+ */
+static std::size_t SelfCheckDay(const DayEntry &entry, std::size_t rounds,
+								std::size_t &checked)
+{
+	std::size_t failed = 0;
+	auto check = [&](std::string_view text, const std::string &source)
+	{
+		checked++;
+		if (!entry.make()->SelfCheck(text, std::cerr))
+		{
+			std::cerr << "ERROR: Day " << entry.day << " self-check failed on "
+					  << source << std::endl;
+			failed++;
+		}
+	};
+	std::ifstream file(entry.input, std::ios::binary);
+	if (file)
+	{
+		std::ostringstream text;
+		text << file.rdbuf();
+		check(text.str(), entry.input);
+	}
+	for (std::size_t round = 0; round < rounds; round++)
+	{
+		// 0 to 64 lines, with the odd input long enough to fill many SIMD
+		// batches. The solvers' threaded variants lower their parallel
+		// thresholds, so the parallel parse and sort run on these too.
+		const std::size_t lines = round % 16 == 15 ? 3000 : round % 65;
+		const uint64_t seed = 0x5e1fc0de + round;
+		check(synthetic::AdversarialText(lines, seed, 2),
+			  "two-column input, seed " + std::to_string(seed));
+		check(synthetic::AdversarialText(lines, seed),
+			  "free-form input, seed " + std::to_string(seed));
+	}
+	return failed;
+}
+
+#ifdef AOC_LIBFUZZER
+// libFuzzer entry: every registered day self-checks the fuzzed text, and a
+// disagreement aborts so the fuzzer keeps the input.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size)
+{
+	std::string_view text(reinterpret_cast<const char *>(data), size);
+	for (const DayEntry &entry : kDays)
+	{
+		if (!entry.make()->SelfCheck(text, std::cerr))
+		{
+			std::abort();
+		}
+	}
+	return 0;
+}
+#else
+int main(int argc, char **argv)
+{
+	RunnerOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		std::string_view value = i + 1 < argc ? argv[i + 1] : "";
+		std::vector<int> parts;
+		// --days <list> picks the days to run, e.g. "1,2"
+		if (arg == "--days" && ParseList(value, options.days))
+		{
+			i++;
+		}
+		// --parts <list> picks the parts, e.g. "2"
+		else if (arg == "--parts" && ParseList(value, parts))
+		{
+			options.partOne = options.partTwo = false;
+			for (int part : parts)
+			{
+				options.partOne |= part == 1;
+				options.partTwo |= part == 2;
+			}
+			i++;
+		}
+		// --concurrent solves the selected days at once, one thread per day
+		// unless --jobs sets the count (tasks always share one pool)
+		else if (arg == "--concurrent")
+		{
+			options.concurrent = true;
+		}
+		// --input <path|glob|@list> solves these files (repeatable)
+		else if (arg == "--input" && !value.empty())
+		{
+			options.inputs.emplace_back(value);
+			i++;
+		}
+		// --jobs <n> solves n inputs at a time (0 = one per hardware thread)
+		else if (arg == "--jobs" && !value.empty() &&
+				 std::from_chars(value.data(), value.data() + value.size(),
+								 options.jobs)
+						 .ec == std::errc())
+		{
+			i++;
+		}
+		// --shards combines the inputs as shards of one dataset
+		else if (arg == "--shards")
+		{
+			options.shards = true;
+		}
+		// --workers <n> maps the shards in n worker processes
+		else if (arg == "--workers" && !value.empty() &&
+				 std::from_chars(value.data(), value.data() + value.size(),
+								 options.workers)
+						 .ec == std::errc())
+		{
+			options.shards = true;
+			i++;
+		}
+		// --launcher <command> starts workers through it, e.g. "ssh node1"
+		// (repeatable: workers take the launchers in turn)
+		else if (arg == "--launcher" && !value.empty())
+		{
+			options.launchers.emplace_back(value);
+			i++;
+		}
+		// --map prints each input's partial result (a worker's output)
+		else if (arg == "--map")
+		{
+			options.map = true;
+		}
+		// --combine <path|glob|@list> combines saved partials (repeatable)
+		else if (arg == "--combine" && !value.empty())
+		{
+			options.combine.emplace_back(value);
+			i++;
+		}
+		// --cache loads each input from its binary cache when it is fresh
+		else if (arg == "--cache")
+		{
+			options.load.cache = true;
+			options.loadArgs.emplace_back(arg);
+		}
+		// --prefetch <auto|io_uring|thread> reads with asynchronous prefetch
+		else if (arg == "--prefetch" &&
+				 PrefetchBackendFromName(value, options.load.prefetchBackend))
+		{
+			options.load.prefetch = true;
+			options.loadArgs.emplace_back(arg);
+			options.loadArgs.emplace_back(value);
+			i++;
+		}
+		// --self-check <n> checks fast paths against reference code on n
+		// rounds of generated inputs
+		else if (arg == "--self-check" && !value.empty() &&
+				 std::from_chars(value.data(), value.data() + value.size(),
+								 options.selfChecks)
+						 .ec == std::errc())
+		{
+			i++;
+		}
+		// --profile prints phase timings and counters as JSON to stderr
+		else if (arg == "--profile")
+		{
+#ifdef AOC_PROFILE
+			profile::Enable();
+#else
+			std::cerr << "--profile needs a build with -DAOC_PROFILE" << std::endl;
+			return 1;
+#endif
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0]
+					  << " [--days 1,2,...] [--parts 1,2] [--concurrent]"
+						 " [--input path|glob|@list]... [--jobs n]"
+						 " [--shards] [--workers n] [--launcher command]..."
+						 " [--map] [--combine path|glob|@list]..."
+						 " [--cache] [--prefetch auto|io_uring|thread]"
+						 " [--self-check n] [--profile]"
+					  << std::endl;
+			return 1;
+		}
+	}
+
+	AOC_PROFILE_REPORT("runner");
+
+	std::vector<const DayEntry *> selected;
+	for (const DayEntry &entry : kDays)
+	{
+		bool wanted = options.days.empty();
+		for (int day : options.days)
+		{
+			wanted |= day == entry.day;
+		}
+		if (wanted)
+		{
+			selected.push_back(&entry);
+		}
+	}
+	for (int day : options.days)
+	{
+		bool known = false;
+		for (const DayEntry &entry : kDays)
+		{
+			known |= entry.day == day;
+		}
+		if (!known)
+		{
+			std::cerr << "Unknown day: " << day << std::endl;
+			return 1;
+		}
+	}
+
+	if (options.selfChecks > 0)
+	{
+		std::size_t failures = 0;
+		for (const DayEntry *entry : selected)
+		{
+			std::size_t checked = 0;
+			std::size_t failed =
+				SelfCheckDay(*entry, options.selfChecks, checked);
+			std::cout << "Day " << entry->day << " self-check: " << checked
+					  << " inputs, " << failed << " failed" << std::endl;
+			failures += failed;
+		}
+		return failures == 0 ? 0 : 1;
+	}
+
+	// Inputs replace the default file of a single day
+	const bool sharded =
+		options.shards || options.map || !options.combine.empty();
+	std::vector<RunTask> tasks;
+	if (sharded && (selected.size() != 1 ||
+					(options.inputs.empty() == options.combine.empty())))
+	{
+		std::cerr << "Sharded runs need exactly one day in --days, and either"
+					 " --input or --combine"
+				  << std::endl;
+		return 1;
+	}
+	if (!options.inputs.empty())
+	{
+		if (selected.size() != 1)
+		{
+			std::cerr << "--input needs exactly one day in --days" << std::endl;
+			return 1;
+		}
+		std::vector<std::string> paths;
+		if (!ExpandInputs(options.inputs, paths))
+		{
+			return 1;
+		}
+		for (std::string &path : paths)
+		{
+			tasks.push_back({selected[0], std::move(path)});
+		}
+	}
+	else if (options.combine.empty())
+	{
+		for (const DayEntry *entry : selected)
+		{
+			tasks.push_back({entry, entry->input});
+		}
+	}
+
+	// Partials come from saved files, worker processes, or this process
+	std::vector<PartialResult> partials;
+	if (!options.combine.empty())
+	{
+		std::vector<std::string> paths;
+		if (!ExpandInputs(options.combine, paths))
+		{
+			return 1;
+		}
+		for (const std::string &path : paths)
+		{
+			std::ifstream in(path);
+			if (!in || !ReadPartials(in, path, partials))
+			{
+				std::cerr << "ERROR: Unable to read partial results: " << path
+						  << std::endl;
+				return 1;
+			}
+		}
+	}
+	else if (options.workers > 0 && !options.map)
+	{
+#if AOC_HAVE_POPEN
+		if (!RunWorkers(tasks, options, argv[0], partials))
+		{
+			return 1;
+		}
+#else
+		std::cerr << "--workers needs a POSIX host (popen)" << std::endl;
+		return 1;
+#endif
+		tasks.clear();
+	}
+
+	// Each task reports into its own buffer, flushed in task order, so
+	// concurrent tasks never interleave their output.
+	std::vector<std::unique_ptr<Reporter>> outputs;
+	for (std::size_t t = 0; t < tasks.size(); t++)
+	{
+		outputs.push_back(std::make_unique<Reporter>(std::cout));
+	}
+	const bool named = !options.inputs.empty();
+	auto solve = [&](std::size_t t)
+	{
+		if (sharded)
+		{
+			MapShard(tasks[t], options);
+		}
+		else
+		{
+			RunDay(tasks[t], options, named, *outputs[t]);
+		}
+	};
+	// --concurrent alone gives each day its own thread; --jobs bounds the
+	// pool either way, so a glob of shards never starts a thread per file
+	std::size_t jobs = options.jobs;
+	if (options.concurrent && jobs == 1)
+	{
+		jobs = selected.size();
+	}
+	if (jobs != 1 && tasks.size() > 1)
+	{
+		// One task per chunk, so idle threads steal the next shard
+		WorkStealingPool pool(jobs);
+		pool.ParallelFor(tasks.size(), 1,
+						 [&](std::size_t begin, std::size_t end, std::size_t)
+						 {
+							 for (std::size_t t = begin; t < end; t++)
+							 {
+								 solve(t);
+							 }
+						 });
+	}
+	else
+	{
+		for (std::size_t t = 0; t < tasks.size(); t++)
+		{
+			solve(t);
+		}
+	}
+
+	if (sharded)
+	{
+		int status = 0;
+		for (RunTask &task : tasks)
+		{
+			if (!task.ok)
+			{
+				std::cerr << "ERROR: Day " << task.entry->day << " failed on "
+						  << task.input << std::endl;
+				status = 1;
+			}
+			else if (!options.map)
+			{
+				partials.push_back(std::move(task.partial));
+			}
+		}
+		if (options.map)
+		{
+			// In input order; a failed shard is still written, marked failed
+			for (const RunTask &task : tasks)
+			{
+				task.partial.Write(std::cout);
+			}
+			std::cout.flush();
+			return status;
+		}
+		if (status != 0)
+		{
+			return status;
+		}
+		int64_t part1 = 0, part2 = 0;
+		selected[0]->make()->Combine(partials, part1, part2);
+		Reporter merged(std::cout);
+		merged.Line("Day " + std::to_string(selected[0]->day) + " merged: " +
+					std::to_string(partials.size()) + " shards");
+		if (options.partOne)
+		{
+			merged.Part(1, part1);
+		}
+		if (options.partTwo)
+		{
+			merged.Part(2, part2);
+		}
+		return 0;
+	}
+
+	int status = 0;
+	std::size_t failed = 0;
+	int64_t part1 = 0, part2 = 0;
+	for (std::size_t t = 0; t < tasks.size(); t++)
+	{
+		const RunTask &task = tasks[t];
+		outputs[t]->Line("");
+		outputs[t]->Flush();
+		if (!task.ok)
+		{
+			std::cerr << "ERROR: Day " << task.entry->day << " failed on "
+					  << task.input << std::endl;
+			failed++;
+			status = 1;
+			continue;
+		}
+		part1 += task.part1;
+		part2 += task.part2;
+	}
+	if (named)
+	{
+		// The aggregate covers the inputs that loaded; any failure still
+		// fails the run
+		Reporter total(std::cout);
+		total.Line("Day " + std::to_string(selected[0]->day) + " total: " +
+				   std::to_string(tasks.size() - failed) + " of " +
+				   std::to_string(tasks.size()) + " inputs");
+		if (options.partOne)
+		{
+			total.Part(1, part1);
+		}
+		if (options.partTwo)
+		{
+			total.Part(2, part2);
+		}
+	}
+	return status;
+}
+#endif // AOC_LIBFUZZER
@@ -0,0 +1,429 @@
+#ifndef AOC_SAFETY_KERNEL_H
+#define AOC_SAFETY_KERNEL_H
+
+#include <cstddef> // For std::size_t
+#include <cstdint>	   // For uint8_t, int64_t
+#include <type_traits> // For std::conditional_t, std::make_unsigned_t
+#include <utility>	   // For std::index_sequence, std::make_index_sequence
+
+#include "profile.h" // For AOC_PROFILE_COUNT (--profile builds)
+
+namespace safety_detail
+{
+// Holds the difference of two levels of type T: int for the narrow tables,
+// int64_t once levels are 32 bits wide and may lie 2^32 - 1 apart.
+template <typename T>
+using Step = std::conditional_t<(sizeof(T) < sizeof(int)), int, int64_t>;
+
+// The step from a to b, in direction dir.
+template <typename T>
+inline Step<T> StepBetween(T a, T b, int dir)
+{
+	return (static_cast<Step<T>>(b) - static_cast<Step<T>>(a)) * dir;
+}
+
+// 1 unless 1 <= step <= 3: the unsigned compare rejects a wrong sign too.
+template <typename S>
+inline unsigned StepOutOfRange(S step)
+{
+	return static_cast<std::make_unsigned_t<S>>(step - 1) > 2u;
+}
+} // namespace safety_detail
+
+/**
+ * @brief Checks that every step of levels[0..n) moves in direction Dir (+1
+ * increasing, -1 decreasing) by 1 to 3.
+ * The direction is a template parameter, so there is no indirect call and no
+ * per-step trend test: each step is one subtract, one multiply by a
+ * constant and one unsigned compare ("step - 1 > 2" rejects both a wrong sign
+ * and a magnitude above 3). Failures are OR-ed into a flag instead of
+ * returning immediately, which keeps the inner loop branch-free and lets the
+ * compiler vectorise it; the flag is only tested once per block of kBlock
+ * steps, so long unsafe reports still stop early.
+ * @tparam Dir +1 or -1.
+ * @tparam T The stored level type (int8_t, int16_t, int...).
+ */
+template <int Dir, typename T>
+inline bool MonotoneWithinThree(const T *levels, std::size_t n)
+{
+	static_assert(Dir == 1 || Dir == -1, "Dir must be +1 or -1");
+	constexpr std::size_t kBlock = 16;
+
+	std::size_t steps = n - 1;
+	std::size_t i = 0;
+	for (; i + kBlock <= steps; i += kBlock)
+	{
+		unsigned bad = 0;
+		for (std::size_t k = i; k < i + kBlock; k++)
+		{
+			bad |= safety_detail::StepOutOfRange(
+				safety_detail::StepBetween(levels[k], levels[k + 1], Dir));
+		}
+		if (bad)
+		{
+			return false;
+		}
+	}
+	unsigned bad = 0;
+	for (; i < steps; i++)
+	{
+		bad |= safety_detail::StepOutOfRange(
+			safety_detail::StepBetween(levels[i], levels[i + 1], Dir));
+	}
+	return bad == 0;
+}
+
+/**
+ * @brief Branch-light equivalent of Day2::processSafe: works out the trend
+ * once from the first two levels, then runs the matching specialisation.
+ * Equal first levels fall through to the decreasing check, which rejects
+ * them, exactly like the original NumCheck path.
+ */
+template <typename T>
+inline bool IsSafeReport(const T *levels, std::size_t n)
+{
+	if (n < 2)
+	{
+		return true;
+	}
+	return levels[0] < levels[1] ? MonotoneWithinThree<1>(levels, n)
+								 : MonotoneWithinThree<-1>(levels, n);
+}
+
+/**
+ * Fixed-length kernels. Inputs are mostly short reports of a few known
+ * lengths, so for N up to kMaxFixedReport the whole check is instantiated
+ * per length: every step is a compile-time index, the loop disappears and a
+ * report compiles down to straight-line code with one final test.
+ * IsSafeShaped / IsSafeDampenedShaped dispatch on the observed length.
+ */
+constexpr std::size_t kMaxFixedReport = 8;
+
+namespace safety_detail
+{
+// Index of level m of the report once level Skip is removed (Skip >= N
+// removes nothing).
+template <std::size_t Skip>
+constexpr std::size_t Kept(std::size_t m)
+{
+	return m < Skip ? m : m + 1;
+}
+
+// 1 if the step from levels[i] to levels[j] is not 1..3 in direction dir.
+template <typename T>
+inline unsigned BadStep(const T *levels, std::size_t i, std::size_t j, int dir)
+{
+	return StepOutOfRange(StepBetween(levels[i], levels[j], dir));
+}
+
+// The IsSafeReport rule over the levels kept when Skip is removed; Step...
+// enumerates the steps of that shorter report.
+template <std::size_t Skip, typename T, std::size_t... Step>
+inline bool SafeSkipping(const T *levels, std::index_sequence<Step...>)
+{
+	const int dir = levels[Kept<Skip>(0)] < levels[Kept<Skip>(1)] ? 1 : -1;
+	unsigned bad =
+		(0u | ... |
+		 BadStep(levels, Kept<Skip>(Step), Kept<Skip>(Step + 1), dir));
+	return bad == 0;
+}
+
+// True if removing some level Skip... leaves a safe report of N - 1 levels.
+// The candidates are OR-ed rather than short-circuited, so there is no
+// branch per removal.
+template <std::size_t N, typename T, std::size_t... Skip>
+inline bool AnyRemovalSafe(const T *levels, std::index_sequence<Skip...>)
+{
+	return (false | ... |
+			SafeSkipping<Skip>(levels, std::make_index_sequence<N - 2>{}));
+}
+} // namespace safety_detail
+
+/**
+ * @brief IsSafeReport for a report of exactly N levels, fully unrolled.
+ */
+template <std::size_t N, typename T>
+inline bool IsSafeFixed(const T *levels)
+{
+	if constexpr (N < 2)
+	{
+		(void)levels;
+		return true;
+	}
+	else
+	{
+		return safety_detail::SafeSkipping<N>(levels,
+											  std::make_index_sequence<N - 1>{});
+	}
+}
+
+/**
+ * @brief Problem-dampener rule for a report of exactly N levels: safe as is,
+ * or safe once any single level is removed. All N removals are checked
+ * unrolled, which for short reports costs less than locating the first bad
+ * step and re-checking around it.
+ */
+template <std::size_t N, typename T>
+inline bool IsSafeDampenedFixed(const T *levels)
+{
+	if constexpr (N < 3)
+	{
+		(void)levels;
+		return true;
+	}
+	else
+	{
+		// Every removal is evaluated: the checks are OR-ed, not short-circuited
+		AOC_PROFILE_COUNT(CandidatesTried, N);
+		return IsSafeFixed<N>(levels) |
+			   safety_detail::AnyRemovalSafe<N>(levels,
+												std::make_index_sequence<N>{});
+	}
+}
+
+/**
+ * @brief IsSafeReport that runs the IsSafeFixed specialisation for reports of
+ * up to kMaxFixedReport levels (one jump on the length) and the generic
+ * kernel for longer ones.
+ */
+template <typename T>
+inline bool IsSafeShaped(const T *levels, std::size_t n)
+{
+	static_assert(kMaxFixedReport == 8, "update the cases below");
+	switch (n)
+	{
+	case 0:
+	case 1:
+		return true;
+	case 2:
+		return IsSafeFixed<2>(levels);
+	case 3:
+		return IsSafeFixed<3>(levels);
+	case 4:
+		return IsSafeFixed<4>(levels);
+	case 5:
+		return IsSafeFixed<5>(levels);
+	case 6:
+		return IsSafeFixed<6>(levels);
+	case 7:
+		return IsSafeFixed<7>(levels);
+	case 8:
+		return IsSafeFixed<8>(levels);
+	default:
+		return IsSafeReport(levels, n);
+	}
+}
+
+/**
+ * @brief Dispatches to IsSafeDampenedFixed on the report length; reports
+ * longer than kMaxFixedReport are handed to generic(), so the caller keeps
+ * its own check for them.
+ */
+template <typename T, typename Generic>
+inline bool IsSafeDampenedShaped(const T *levels, std::size_t n,
+								 Generic &&generic)
+{
+	static_assert(kMaxFixedReport == 8, "update the cases below");
+	switch (n)
+	{
+	case 0:
+	case 1:
+	case 2:
+		return true;
+	case 3:
+		return IsSafeDampenedFixed<3>(levels);
+	case 4:
+		return IsSafeDampenedFixed<4>(levels);
+	case 5:
+		return IsSafeDampenedFixed<5>(levels);
+	case 6:
+		return IsSafeDampenedFixed<6>(levels);
+	case 7:
+		return IsSafeDampenedFixed<7>(levels);
+	case 8:
+		return IsSafeDampenedFixed<8>(levels);
+	default:
+		return generic();
+	}
+}
+
+/**
+ * Rich classification. ClassifyReport says where a report first breaks the
+ * rule and why, instead of just yes or no, so that later passes (the
+ * problem dampener, the statistics) pick up from the failure point rather
+ * than scanning the report again from its first level.
+ */
+enum class StepFailure : uint8_t
+{
+	None,	  // Safe: every step moves 1..3 in the report's direction
+	Flat,	  // Two equal neighbouring levels
+	Reversed, // A step against the direction set by the first two levels
+	TooFar,	  // A step of more than 3 in the right direction
+};
+
+struct SafetyResult
+{
+	StepFailure failure = StepFailure::None;
+	// Direction set by the first two levels: +1 increasing, -1 decreasing
+	int dir = 1;
+	// First failing step, from levels[step] to the next level; n when safe
+	std::size_t step = 0;
+
+	bool Safe() const { return failure == StepFailure::None; }
+};
+
+/**
+ * @brief Scans levels[0..n) with level 'skip' left out (pass n to keep every
+ * level), requiring each step between kept neighbours to move in direction
+ * 'dir' by 1 to 3. Steps that start before level 'from' are taken as already
+ * checked.
+ * @return The level whose step to the next kept level fails, or n.
+ */
+template <typename T>
+inline std::size_t FirstBadStep(const T *levels, std::size_t n, int dir,
+								std::size_t skip, std::size_t from = 0)
+{
+	std::size_t prev = from == skip ? from + 1 : from;
+	for (std::size_t i = prev + 1; i < n; i++)
+	{
+		if (i == skip)
+		{
+			continue;
+		}
+		if (safety_detail::BadStep(levels, prev, i, dir))
+		{
+			return prev;
+		}
+		prev = i;
+	}
+	return n;
+}
+
+namespace safety_detail
+{
+template <typename T>
+inline SafetyResult ResultAt(const T *levels, std::size_t n, int dir,
+							 std::size_t step)
+{
+	SafetyResult result;
+	result.dir = dir;
+	result.step = step;
+	if (step < n)
+	{
+		auto move = StepBetween(levels[step], levels[step + 1], dir);
+		result.failure = move == 0	 ? StepFailure::Flat
+						 : move < 0 ? StepFailure::Reversed
+									: StepFailure::TooFar;
+	}
+	return result;
+}
+
+// Bit s set if step s of an N-level report fails, unrolled like IsSafeFixed.
+template <typename T, std::size_t... Step>
+inline unsigned FailingSteps(const T *levels, int dir,
+							 std::index_sequence<Step...>)
+{
+	return (0u | ... | (BadStep(levels, Step, Step + 1, dir) << Step));
+}
+} // namespace safety_detail
+
+/**
+ * @brief Classifies a report by the IsSafeReport rule and locates its first
+ * failure. Steps that start before level 'from' are taken as already known
+ * to pass (e.g. from an earlier, shorter scan).
+ */
+template <typename T>
+inline SafetyResult ClassifyReport(const T *levels, std::size_t n,
+								   std::size_t from = 0)
+{
+	if (n < 2)
+	{
+		return safety_detail::ResultAt(levels, n, 1, n);
+	}
+	int dir = levels[0] < levels[1] ? 1 : -1;
+	return safety_detail::ResultAt(levels, n, dir,
+								   FirstBadStep(levels, n, dir, n, from));
+}
+
+/**
+ * @brief ClassifyReport with the unrolled kernels for reports of up to
+ * kMaxFixedReport levels: every step is checked at once into a bit mask and
+ * the first failure is its lowest set bit, so a short report costs the same
+ * as IsSafeShaped.
+ */
+template <typename T>
+inline SafetyResult ClassifyShaped(const T *levels, std::size_t n)
+{
+	if (n < 2 || n > kMaxFixedReport)
+	{
+		return ClassifyReport(levels, n);
+	}
+	int dir = levels[0] < levels[1] ? 1 : -1;
+	unsigned failing = 0;
+	switch (n)
+	{
+	case 2:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<1>{});
+		break;
+	case 3:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<2>{});
+		break;
+	case 4:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<3>{});
+		break;
+	case 5:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<4>{});
+		break;
+	case 6:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<5>{});
+		break;
+	case 7:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<6>{});
+		break;
+	default:
+		failing = safety_detail::FailingSteps(levels, dir,
+											  std::make_index_sequence<7>{});
+		break;
+	}
+	std::size_t step =
+		failing ? static_cast<std::size_t>(__builtin_ctz(failing)) : n;
+	return safety_detail::ResultAt(levels, n, dir, step);
+}
+
+/**
+ * @brief Problem-dampener rule for a report that 'first' (its ClassifyReport
+ * result) found unsafe: is it safe once one level is removed?
+ * A safe report moves the same way at every step, so each direction is
+ * tried. In the report's own direction the first failure is step
+ * first.step, and only removing level step or step + 1 can mend it; the
+ * steps before step - 1 are unchanged and known to pass, so the rescan
+ * starts there. In the opposite direction step 0 already fails, so level 0
+ * or 1 has to go.
+ */
+template <typename T>
+inline bool SafeWithOneRemoval(const T *levels, std::size_t n,
+							   const SafetyResult &first)
+{
+	if (first.Safe() || n < 3)
+	{
+		return true;
+	}
+	const std::size_t f = first.step;
+	const int dir = first.dir;
+	// Rescans in 'd' with level 'skip' removed, starting at 'from'
+	auto mends = [&](int d, std::size_t skip, std::size_t from)
+	{
+		AOC_PROFILE_COUNT(CandidatesTried, 1);
+		return FirstBadStep(levels, n, d, skip, from) == n;
+	};
+	return mends(dir, f, f == 0 ? 0 : f - 1) || mends(dir, f + 1, f) ||
+		   mends(-dir, 0, 0) || mends(-dir, 1, 0);
+}
+
+#endif // AOC_SAFETY_KERNEL_H
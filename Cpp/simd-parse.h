@@ -0,0 +1,440 @@
+#ifndef AOC_SIMD_PARSE_H
+#define AOC_SIMD_PARSE_H
+
+#include <cctype>	   // For std::isspace (scalar reference)
+#include <charconv>	   // For std::from_chars (scalar reference)
+#include <cstddef>	   // For std::size_t
+#include <cstdint>	   // For uint64_t
+#include <cstring>	   // For std::memcpy
+#include <string_view> // For std::string_view
+#include <vector>	   // For std::vector
+
+#include "simd-target.h" // For AOC_TARGET, AOC_X86, AOC_NEON
+
+/**
+ * @brief The available implementations of the delimited-integer parser.
+ * Auto resolves to the widest backend the running CPU supports.
+ */
+enum class ParseBackend
+{
+	Auto,
+	Scalar,
+	SSE42,
+	AVX2,
+	NEON,
+};
+
+// Every concrete backend, for callers that try them all (the benchmarks and
+// the self-checks); skip the ones ParseBackendSupported rejects.
+constexpr ParseBackend kParseBackends[] = {ParseBackend::Scalar,
+										   ParseBackend::SSE42,
+										   ParseBackend::AVX2, ParseBackend::NEON};
+
+/**
+ * @brief Signature shared by every parser backend: parses the space/comma
+ * delimited integers in 's' and appends them to 'numbers'.
+ */
+using IntParser = void (*)(std::string_view s, std::vector<int> &numbers);
+
+/**
+ * @brief Scalar reference parser: the std::isspace + std::from_chars loop the
+ * solvers always used. The vector backends must produce identical output, and
+ * fall back to this for any line they don't handle natively.
+ */
+inline void ParseIntsScalar(std::string_view s, std::vector<int> &numbers)
+{
+	const char *str = s.data();
+	const char *end = str + s.size();
+
+	while (str < end)
+	{
+		// Skip leading whitespace or comma delimiters
+		while (str < end && (std::isspace(static_cast<unsigned char>(*str)) ||
+							 *str == ','))
+		{
+			++str;
+		}
+		if (str >= end)
+		{
+			break;
+		}
+
+		int value;
+		auto [ptr, ec] = std::from_chars(str, end, value);
+		if (ec != std::errc())
+		{
+			// Non-numeric text: stop processing this line
+			break;
+		}
+		numbers.push_back(value);
+		str = ptr;
+	}
+}
+
+namespace simd_parse_detail
+{
+// Longest digit run converted natively; anything longer could overflow an
+// int, so the whole line is handed to the scalar reference instead.
+constexpr std::size_t kMaxDigits = 9;
+
+/**
+ * @brief Converts 1..8 ASCII digits packed little-endian into a 64-bit word
+ * (first digit in the lowest byte) with three multiplies instead of a
+ * multiply-add per digit.
+ */
+AOC_ALWAYS_INLINE uint32_t SwarEightDigits(uint64_t val, std::size_t len)
+{
+	// Keep only the 'len' digit bytes, strip the ASCII bias, then shift so the
+	// digits are right-aligned and the missing high-order digits read as '0'.
+	uint64_t keep = len == 8 ? ~0ULL : ((1ULL << (8 * len)) - 1);
+	val = (val & keep) - (0x3030303030303030ULL & keep);
+	val <<= 8 * (8 - len);
+	val = (val * 10) + (val >> 8);
+	val = (((val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+		   (((val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+		  32;
+	return static_cast<uint32_t>(val);
+}
+
+/**
+ * @brief Converts the digit run [p, p + len) of a line ending at 'end'. Runs of
+ * four or more digits (the Day 1 columns) go through the SWAR kernel whenever
+ * eight bytes can be read without leaving the line.
+ */
+AOC_ALWAYS_INLINE int ConvertDigits(const char *p, std::size_t len,
+									const char *end)
+{
+	if (len >= 4 && len <= 8 && p + 8 <= end)
+	{
+		uint64_t word;
+		std::memcpy(&word, p, 8);
+		return static_cast<int>(SwarEightDigits(word, len));
+	}
+	int value = 0;
+	for (std::size_t i = 0; i < len; i++)
+	{
+		value = value * 10 + (p[i] - '0');
+	}
+	return value;
+}
+
+/**
+ * @brief Shared, ISA-independent half of the vector parsers. Each backend
+ * loads and classifies W bytes at a time into a bitmask of digit bytes and one
+ * of delimiter bytes; Consume() then walks the digit runs with
+ * count-trailing-zeros, so no per-byte branching happens. Runs that touch the
+ * end of a block are carried into the next one.
+ */
+class BlockCursor
+{
+public:
+	const char *const begin;
+	const char *const end;
+
+	BlockCursor(std::string_view s, std::vector<int> &numbers)
+		: begin(s.data()), end(s.data() + s.size()), numbers(numbers),
+		  start(numbers.size())
+	{
+	}
+
+	/**
+	 * @brief Returns a pointer to W readable bytes for the block at 'p'. Full
+	 * blocks are read in place; the tail is copied into 'tail' so the load
+	 * never runs past the line (or the end of the mapping).
+	 */
+	AOC_ALWAYS_INLINE const char *Load(const char *p, std::size_t W,
+									   char *tail) const
+	{
+		std::size_t avail = static_cast<std::size_t>(end - p);
+		if (avail >= W)
+		{
+			return p;
+		}
+		std::memset(tail, 0, W);
+		std::memcpy(tail, p, avail);
+		return tail;
+	}
+
+	/**
+	 * @brief Emits every number that ends inside the block at 'p'.
+	 * @return false if the line contains anything other than digits and
+	 * delimiters (signs, text, over-long numbers). 'numbers' is then restored
+	 * and the caller re-parses the line with the scalar reference.
+	 */
+	AOC_ALWAYS_INLINE bool Consume(const char *p, std::size_t W,
+								   uint64_t digits, uint64_t delims)
+	{
+		std::size_t avail = static_cast<std::size_t>(end - p);
+		bool last = avail <= W;
+		uint64_t live = last ? ((1ULL << avail) - 1) : ((1ULL << W) - 1);
+		digits &= live;
+		if ((digits | (delims & live)) != live)
+		{
+			return Fail();
+		}
+
+		uint64_t m = digits;
+		if (runLen > 0)
+		{
+			// Continue the number carried over from the previous block.
+			std::size_t lead = static_cast<std::size_t>(__builtin_ctzll(~m));
+			runLen += lead;
+			if (runLen > kMaxDigits)
+			{
+				return Fail();
+			}
+			if (lead == W && !last)
+			{
+				return true;
+			}
+			numbers.push_back(ConvertDigits(runStart, runLen, end));
+			runLen = 0;
+			m &= ~0ULL << lead;
+		}
+		while (m)
+		{
+			std::size_t pos = static_cast<std::size_t>(__builtin_ctzll(m));
+			std::size_t len =
+				static_cast<std::size_t>(__builtin_ctzll(~(m >> pos)));
+			if (pos + len == W && !last)
+			{
+				// The run touches the block edge and may continue.
+				runStart = p + pos;
+				runLen = len;
+				return true;
+			}
+			if (len > kMaxDigits)
+			{
+				return Fail();
+			}
+			numbers.push_back(ConvertDigits(p + pos, len, end));
+			m &= ~0ULL << (pos + len);
+		}
+		return true;
+	}
+
+private:
+	std::vector<int> &numbers;
+	const std::size_t start;
+	// A digit run that reached the end of the previous block.
+	const char *runStart = nullptr;
+	std::size_t runLen = 0;
+
+	bool Fail()
+	{
+		numbers.resize(start);
+		return false;
+	}
+};
+
+#if AOC_X86
+AOC_TARGET("sse4.2")
+inline void ParseIntsSse42(std::string_view s, std::vector<int> &numbers)
+{
+	constexpr std::size_t W = 16;
+	BlockCursor cursor(s, numbers);
+	// PCMPESTRM "equal any" against the delimiter set gives the whole
+	// delimiter mask in one instruction.
+	const __m128i set = _mm_setr_epi8(' ', '\t', '\n', '\v', '\f', '\r', ',',
+									  0, 0, 0, 0, 0, 0, 0, 0, 0);
+	for (const char *p = cursor.begin; p < cursor.end; p += W)
+	{
+		alignas(16) char tail[W];
+		__m128i block = _mm_loadu_si128(
+			reinterpret_cast<const __m128i *>(cursor.Load(p, W, tail)));
+		__m128i t = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+		__m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t);
+		__m128i isDelim = _mm_cmpestrm(
+			set, 7, block, 16,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_UNIT_MASK);
+		if (!cursor.Consume(
+				p, W, static_cast<uint32_t>(_mm_movemask_epi8(isDigit)),
+				static_cast<uint32_t>(_mm_movemask_epi8(isDelim))))
+		{
+			ParseIntsScalar(s, numbers);
+			return;
+		}
+	}
+}
+
+AOC_TARGET("avx2")
+inline void ParseIntsAvx2(std::string_view s, std::vector<int> &numbers)
+{
+	constexpr std::size_t W = 32;
+	BlockCursor cursor(s, numbers);
+	for (const char *p = cursor.begin; p < cursor.end; p += W)
+	{
+		alignas(32) char tail[W];
+		__m256i block = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i *>(cursor.Load(p, W, tail)));
+		__m256i t = _mm256_sub_epi8(block, _mm256_set1_epi8('0'));
+		__m256i isDigit =
+			_mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(9)), t);
+		// '\t'..'\r' are contiguous: one unsigned range test covers all five.
+		__m256i ws = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+		__m256i isDelim = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+							_mm256_cmpeq_epi8(block, _mm256_set1_epi8(','))),
+			_mm256_cmpeq_epi8(_mm256_min_epu8(ws, _mm256_set1_epi8(4)), ws));
+		if (!cursor.Consume(
+				p, W, static_cast<uint32_t>(_mm256_movemask_epi8(isDigit)),
+				static_cast<uint32_t>(_mm256_movemask_epi8(isDelim))))
+		{
+			ParseIntsScalar(s, numbers);
+			return;
+		}
+	}
+}
+#endif // AOC_X86
+
+#if AOC_NEON
+// NEON has no movemask; weight each lane by its bit and add across halves.
+AOC_ALWAYS_INLINE uint64_t NeonMoveMask(uint8x16_t v)
+{
+	const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128,
+							 1, 2, 4, 8, 16, 32, 64, 128};
+	uint8x16_t masked = vandq_u8(v, bits);
+	return static_cast<uint64_t>(vaddv_u8(vget_low_u8(masked))) |
+		   (static_cast<uint64_t>(vaddv_u8(vget_high_u8(masked))) << 8);
+}
+
+inline void ParseIntsNeon(std::string_view s, std::vector<int> &numbers)
+{
+	constexpr std::size_t W = 16;
+	BlockCursor cursor(s, numbers);
+	for (const char *p = cursor.begin; p < cursor.end; p += W)
+	{
+		alignas(16) char tail[W];
+		uint8x16_t block = vld1q_u8(
+			reinterpret_cast<const uint8_t *>(cursor.Load(p, W, tail)));
+		uint8x16_t isDigit =
+			vcleq_u8(vsubq_u8(block, vdupq_n_u8('0')), vdupq_n_u8(9));
+		uint8x16_t isDelim = vorrq_u8(
+			vorrq_u8(vceqq_u8(block, vdupq_n_u8(' ')),
+					 vceqq_u8(block, vdupq_n_u8(','))),
+			vcleq_u8(vsubq_u8(block, vdupq_n_u8('\t')), vdupq_n_u8(4)));
+		if (!cursor.Consume(p, W, NeonMoveMask(isDigit),
+							NeonMoveMask(isDelim)))
+		{
+			ParseIntsScalar(s, numbers);
+			return;
+		}
+	}
+}
+#endif // AOC_NEON
+} // namespace simd_parse_detail
+
+/**
+ * @brief Returns true if 'backend' was compiled in and the running CPU can
+ * execute it. Scalar and Auto are always supported.
+ */
+inline bool ParseBackendSupported(ParseBackend backend)
+{
+	switch (backend)
+	{
+	case ParseBackend::Auto:
+	case ParseBackend::Scalar:
+		return true;
+#if AOC_X86
+	case ParseBackend::SSE42:
+		return __builtin_cpu_supports("sse4.2");
+	case ParseBackend::AVX2:
+		return __builtin_cpu_supports("avx2");
+#endif
+#if AOC_NEON
+	case ParseBackend::NEON:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Picks the widest backend supported by the running CPU. The result
+ * is computed once and cached.
+ */
+inline ParseBackend DetectParseBackend()
+{
+	static const ParseBackend best = []
+	{
+		for (ParseBackend b :
+			 {ParseBackend::AVX2, ParseBackend::SSE42, ParseBackend::NEON})
+		{
+			if (ParseBackendSupported(b))
+			{
+				return b;
+			}
+		}
+		return ParseBackend::Scalar;
+	}();
+	return best;
+}
+
+/**
+ * @brief Resolves 'backend' to a parser function. Auto, or a backend the CPU
+ * can't run, resolves to the best supported one.
+ */
+inline IntParser SelectIntParser(ParseBackend backend)
+{
+	if (backend == ParseBackend::Auto || !ParseBackendSupported(backend))
+	{
+		backend = DetectParseBackend();
+	}
+	switch (backend)
+	{
+#if AOC_X86
+	case ParseBackend::SSE42:
+		return simd_parse_detail::ParseIntsSse42;
+	case ParseBackend::AVX2:
+		return simd_parse_detail::ParseIntsAvx2;
+#endif
+#if AOC_NEON
+	case ParseBackend::NEON:
+		return simd_parse_detail::ParseIntsNeon;
+#endif
+	default:
+		return ParseIntsScalar;
+	}
+}
+
+/**
+ * @brief Human-readable backend name, matching ParseBackendFromName.
+ */
+inline const char *ParseBackendName(ParseBackend backend)
+{
+	switch (backend)
+	{
+	case ParseBackend::Scalar:
+		return "scalar";
+	case ParseBackend::SSE42:
+		return "sse4.2";
+	case ParseBackend::AVX2:
+		return "avx2";
+	case ParseBackend::NEON:
+		return "neon";
+	default:
+		return "auto";
+	}
+}
+
+/**
+ * @brief Parses a backend name ("auto", "scalar", "sse4.2", "avx2", "neon").
+ * @return false if the name is not recognised.
+ */
+inline bool ParseBackendFromName(std::string_view name, ParseBackend &backend)
+{
+	for (ParseBackend b : {ParseBackend::Auto, ParseBackend::Scalar,
+						   ParseBackend::SSE42, ParseBackend::AVX2,
+						   ParseBackend::NEON})
+	{
+		if (name == ParseBackendName(b))
+		{
+			backend = b;
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif // AOC_SIMD_PARSE_H
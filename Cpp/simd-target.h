@@ -0,0 +1,34 @@
+#ifndef AOC_SIMD_TARGET_H
+#define AOC_SIMD_TARGET_H
+
+// Shared ISA detection for the vector kernels (simd-parse.h, report-batch.h).
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AOC_X86 1
+#include <immintrin.h> // SSE4.2 / AVX2 / AVX-512 intrinsics
+#else
+#define AOC_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define AOC_NEON 1
+#include <arm_neon.h> // NEON intrinsics
+#else
+#define AOC_NEON 0
+#endif
+
+// Per-function ISA selection, so one binary carries every backend and picks
+// one at runtime instead of needing -mavx2 for the whole program.
+#if AOC_X86 && (defined(__GNUC__) || defined(__clang__))
+#define AOC_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AOC_TARGET(isa)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AOC_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define AOC_ALWAYS_INLINE inline
+#endif
+
+#endif // AOC_SIMD_TARGET_H
@@ -0,0 +1,309 @@
+#ifndef AOC_SYNTHETIC_INPUT_H
+#define AOC_SYNTHETIC_INPUT_H
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For uint64_t
+#include <string>  // For std::string, std::to_string
+#include <vector>  // For std::vector
+
+/**
+ * @brief Deterministic generators for puzzle-shaped inputs of any size, used by
+ * the benchmarks and by generate-input.cpp. The same spec and seed always
+ * yield the same text, and text can be produced in pieces so arbitrarily
+ * large inputs never have to fit in memory.
+ */
+namespace synthetic
+{
+// SplitMix64: tiny, fast and good enough to shape test data.
+class Rng
+{
+public:
+	explicit Rng(uint64_t seed) : state(seed) {}
+
+	uint64_t Next()
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// Uniform in [lo, hi].
+	int Between(int lo, int hi)
+	{
+		return lo + static_cast<int>(Next() % (static_cast<uint64_t>(hi) -
+											   static_cast<uint64_t>(lo) + 1));
+	}
+
+	// True with probability p.
+	bool Chance(double p)
+	{
+		return static_cast<double>(Next() >> 11) * 0x1.0p-53 < p;
+	}
+
+private:
+	uint64_t state;
+};
+
+// Appends the decimal digits of a non-negative 'value'.
+inline void AppendInt(std::string &out, int value)
+{
+	char digits[12];
+	int n = 0;
+	do
+	{
+		digits[n++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	while (n > 0)
+	{
+		out += digits[--n];
+	}
+}
+
+// Shape of a Day 1 input: two columns of IDs separated by three spaces.
+struct Day1Spec
+{
+	int minValue = 10000;
+	int maxValue = 99999;
+	// Probability that a value repeats one drawn recently (from either
+	// column) instead of being fresh, which drives the similarity score.
+	double duplicateRate = 0.0;
+};
+
+/**
+ * @brief Appends Day 1 lines. Repeats are drawn from a ring of the last 4096
+ * values, so memory stays constant however many lines are generated.
+ */
+class Day1Generator
+{
+public:
+	Day1Generator(const Day1Spec &spec, uint64_t seed)
+		: spec(spec), rng(seed), recent(4096)
+	{
+	}
+
+	void Append(std::string &out, std::size_t lines)
+	{
+		for (std::size_t i = 0; i < lines; i++)
+		{
+			AppendInt(out, Draw());
+			out += "   ";
+			AppendInt(out, Draw());
+			out += '\n';
+		}
+	}
+
+private:
+	Day1Spec spec;
+	Rng rng;
+	std::vector<int> recent;
+	std::size_t drawn = 0;
+
+	int Draw()
+	{
+		int value;
+		if (drawn > 0 && rng.Chance(spec.duplicateRate))
+		{
+			std::size_t window = drawn < recent.size() ? drawn : recent.size();
+			value = recent[rng.Next() % window];
+		}
+		else
+		{
+			value = rng.Between(spec.minValue, spec.maxValue);
+		}
+		recent[drawn++ % recent.size()] = value;
+		return value;
+	}
+};
+
+// Shape of a Day 2 input: one report of levels per line.
+struct Day2Spec
+{
+	int minLength = 5;
+	int maxLength = 8;
+	// Fraction of reports that are safe as-is, and of reports that become
+	// safe after removing one level; the rest stay unsafe either way.
+	double safeFraction = 0.5;
+	double fixableFraction = 0.25;
+};
+
+/**
+ * @brief Appends Day 2 reports. Safe reports are strictly monotone with
+ * steps of 1 to 3. Fixable ones are a safe report with one level repeated.
+ * Unsafe ones repeat two different levels, or for reports shorter than four
+ * levels, use steps of 10 or more, so no single removal can fix them. Reports
+ * of one level are always safe and of two always fixable, whatever the spec.
+ */
+class Day2Generator
+{
+public:
+	Day2Generator(const Day2Spec &spec, uint64_t seed)
+		: spec(spec), rng(seed)
+	{
+		if (this->spec.minLength < 1)
+		{
+			this->spec.minLength = 1;
+		}
+		if (this->spec.maxLength < this->spec.minLength)
+		{
+			this->spec.maxLength = this->spec.minLength;
+		}
+	}
+
+	void Append(std::string &out, std::size_t lines)
+	{
+		for (std::size_t i = 0; i < lines; i++)
+		{
+			int length = rng.Between(spec.minLength, spec.maxLength);
+			double pick = static_cast<double>(rng.Next() >> 11) * 0x1.0p-53;
+			if (pick < spec.safeFraction || length < 2)
+			{
+				Monotone(length, 1, 3);
+			}
+			else if (pick < spec.safeFraction + spec.fixableFraction ||
+					 length < 3)
+			{
+				Monotone(length - 1, 1, 3);
+				Repeat(static_cast<std::size_t>(rng.Between(0, length - 2)));
+			}
+			else if (length < 4)
+			{
+				Monotone(length, 10, 20);
+			}
+			else
+			{
+				Monotone(length - 2, 1, 3);
+				int first = rng.Between(0, length - 3);
+				Repeat(static_cast<std::size_t>(first));
+				// A second repeat that doesn't touch the first pair
+				int second = first + 2 <= length - 2
+								 ? rng.Between(first + 2, length - 2)
+								 : rng.Between(0, first - 1);
+				Repeat(static_cast<std::size_t>(second));
+			}
+			for (std::size_t k = 0; k < levels.size(); k++)
+			{
+				if (k > 0)
+				{
+					out += ' ';
+				}
+				AppendInt(out, levels[k]);
+			}
+			out += '\n';
+		}
+	}
+
+private:
+	Day2Spec spec;
+	Rng rng;
+	std::vector<int> levels;
+
+	// Fills 'levels' with a strictly monotone run whose steps lie in
+	// [minStep, maxStep], kept positive.
+	void Monotone(int length, int minStep, int maxStep)
+	{
+		levels.clear();
+		int dir = rng.Next() & 1 ? 1 : -1;
+		int level = rng.Between(1, 99);
+		if (dir < 0)
+		{
+			level += maxStep * (length - 1);
+		}
+		for (int k = 0; k < length; k++)
+		{
+			levels.push_back(level);
+			level += dir * rng.Between(minStep, maxStep);
+		}
+	}
+
+	// Duplicates the level at 'at', creating one zero step after it.
+	void Repeat(std::size_t at)
+	{
+		levels.insert(levels.begin() + at, levels[at]);
+	}
+};
+
+/**
+ * @brief Lines of integers meant to trip up the parsers and the safety checks
+ * rather than to look like puzzle input, for the self-checks. With 'columns'
+ * set, lines hold that many values (bar the odd broken line); otherwise
+ * reports of 0 to 12 levels. Values walk in steps of 0 to 4 that sometimes
+ * reverse, so equal and over-long steps are common, and negative numbers,
+ * int32_t extremes, out-of-range and malformed tokens, tabs, commas, runs of
+ * spaces, CRLF endings and blank lines are mixed in.
+ */
+inline std::string AdversarialText(std::size_t lines, uint64_t seed,
+								   int columns = 0)
+{
+	static const char *const kSeparators[] = {" ", " ", " ", "   ", ",", ", ",
+											  "\t"};
+	static const char *const kMalformed[] = {"x", "-", "+1", "1a", "--3",
+											 "99999999999", "-2147483649"};
+	static const long long kExtremes[] = {-2147483647 - 1, 2147483647,
+										  2147483645, -2147483646, 0};
+	Rng rng(seed);
+	std::string out;
+	for (std::size_t i = 0; i < lines; i++)
+	{
+		if (rng.Chance(0.02))
+		{
+			out += rng.Chance(0.5) ? "\n" : "  \n";
+			continue;
+		}
+		int length = columns > 0 ? (rng.Chance(0.01) ? 1 : columns)
+					 : rng.Chance(0.1) ? rng.Between(0, 1)
+									   : rng.Between(2, 12);
+		long long level = rng.Chance(0.05) ? kExtremes[rng.Between(0, 4)]
+						  : rng.Chance(0.2) ? rng.Between(-100, 100)
+											: rng.Between(1, 99);
+		int dir = rng.Chance(0.5) ? 1 : -1;
+		for (int k = 0; k < length; k++)
+		{
+			if (k > 0)
+			{
+				out += kSeparators[rng.Between(0, 6)];
+			}
+			if (rng.Chance(0.005))
+			{
+				out += kMalformed[rng.Between(0, 6)];
+			}
+			else
+			{
+				out += std::to_string(level);
+			}
+			level += (rng.Chance(0.1) ? -dir : dir) * rng.Between(0, 4);
+		}
+		if (rng.Chance(0.02))
+		{
+			out += ' ';
+		}
+		out += rng.Chance(0.05) ? "\r\n" : "\n";
+	}
+	if (!out.empty() && rng.Chance(0.3))
+	{
+		out.pop_back(); // No newline at the end of the last line
+	}
+	return out;
+}
+
+inline std::string Day1Text(std::size_t lines, uint64_t seed = 1,
+							const Day1Spec &spec = Day1Spec())
+{
+	std::string out;
+	out.reserve(lines * 14);
+	Day1Generator(spec, seed).Append(out, lines);
+	return out;
+}
+
+inline std::string Day2Text(std::size_t lines, uint64_t seed = 2,
+							const Day2Spec &spec = Day2Spec())
+{
+	std::string out;
+	out.reserve(lines * 20);
+	Day2Generator(spec, seed).Append(out, lines);
+	return out;
+}
+} // namespace synthetic
+
+#endif // AOC_SYNTHETIC_INPUT_H
@@ -0,0 +1,218 @@
+#ifndef AOC_THREAD_POOL_H
+#define AOC_THREAD_POOL_H
+
+#include <algorithm>		  // For std::min, std::max
+#include <atomic>			  // For std::atomic
+#include <condition_variable> // For std::condition_variable
+#include <cstddef>			  // For std::size_t
+#include <deque>			  // For std::deque (per-worker task queues)
+#include <functional>		  // For std::function
+#include <memory>			  // For std::unique_ptr
+#include <mutex>			  // For std::mutex, std::lock_guard
+#include <thread>			  // For std::thread
+#include <vector>			  // For std::vector
+
+/**
+ * @brief A fixed set of worker threads, each with its own task deque.
+ * ParallelFor() cuts an index range into chunks and deals them round-robin
+ * onto the deques. A worker pops its own newest chunk first (cache-warm) and,
+ * once its deque is empty, steals the oldest chunk from another worker. Uneven
+ * chunk costs (e.g. Day 2 reports of different lengths) therefore even out
+ * without a static split. The calling thread takes part as worker 0.
+ */
+class WorkStealingPool
+{
+public:
+	// fn(begin, end, worker): process indices [begin, end) on 'worker'.
+	using RangeFn = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+	/**
+	 * @param threads Total number of threads including the caller; 0 means
+	 * one per hardware thread.
+	 */
+	explicit WorkStealingPool(std::size_t threads = 0)
+	{
+		if (threads == 0)
+		{
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (std::size_t i = 0; i < threads; i++)
+		{
+			queues.push_back(std::make_unique<Queue>());
+		}
+		for (std::size_t i = 1; i < threads; i++)
+		{
+			workers.emplace_back([this, i] { WorkerLoop(i); });
+		}
+	}
+
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stop = true;
+		}
+		wake.notify_all();
+		for (std::thread &t : workers)
+		{
+			t.join();
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool &) = delete;
+	WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+	// Number of threads that may run chunks, including the caller.
+	std::size_t Size() const { return queues.size(); }
+
+	/**
+	 * @brief Runs fn over [0, count) in chunks of 'grain' indices and returns
+	 * once every chunk has finished. Only one ParallelFor may run at a time.
+	 */
+	void ParallelFor(std::size_t count, std::size_t grain, const RangeFn &fn)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		grain = std::max<std::size_t>(grain, 1);
+		if (Size() == 1 || count <= grain)
+		{
+			fn(0, count, 0);
+			return;
+		}
+
+		std::size_t chunks = (count + grain - 1) / grain;
+		pending.store(chunks, std::memory_order_relaxed);
+		for (std::size_t c = 0; c < chunks; c++)
+		{
+			Queue &q = *queues[c % Size()];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			q.tasks.push_back(
+				{c * grain, std::min(count, (c + 1) * grain), &fn});
+		}
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			generation++;
+		}
+		wake.notify_all();
+
+		// Work alongside the pool, then wait for chunks still in flight.
+		RunAvailable(0);
+		std::unique_lock<std::mutex> lock(doneMutex);
+		done.wait(lock, [this]
+				  { return pending.load(std::memory_order_acquire) == 0; });
+	}
+
+	/**
+	 * @brief Parallel map-reduce over [0, count): each worker folds its chunks
+	 * into a private, cache-line padded accumulator with
+	 * acc = fn(begin, end, acc), and the accumulators are combined with '+' at
+	 * the end. Nothing is shared between threads while chunks run.
+	 */
+	template <typename T, typename Fn>
+	T ParallelSum(std::size_t count, std::size_t grain, Fn &&fn)
+	{
+		struct alignas(64) Slot
+		{
+			T value{};
+		};
+		std::vector<Slot> slots(Size());
+		ParallelFor(count, grain,
+					[&](std::size_t begin, std::size_t end, std::size_t worker)
+					{ slots[worker].value += fn(begin, end); });
+		T total{};
+		for (const Slot &slot : slots)
+		{
+			total += slot.value;
+		}
+		return total;
+	}
+
+private:
+	struct Task
+	{
+		std::size_t begin;
+		std::size_t end;
+		const RangeFn *fn;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	std::size_t generation = 0;
+	bool stop = false;
+
+	std::atomic<std::size_t> pending{0};
+	std::mutex doneMutex;
+	std::condition_variable done;
+
+	// Own queue from the back (most recently dealt), others from the front.
+	bool TryPop(std::size_t self, Task &task)
+	{
+		for (std::size_t k = 0; k < Size(); k++)
+		{
+			Queue &q = *queues[(self + k) % Size()];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (!q.tasks.empty())
+			{
+				if (k == 0)
+				{
+					task = q.tasks.back();
+					q.tasks.pop_back();
+				}
+				else
+				{
+					task = q.tasks.front();
+					q.tasks.pop_front();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void RunAvailable(std::size_t self)
+	{
+		Task task;
+		while (TryPop(self, task))
+		{
+			(*task.fn)(task.begin, task.end, self);
+			if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::lock_guard<std::mutex> lock(doneMutex);
+				done.notify_all();
+			}
+		}
+	}
+
+	void WorkerLoop(std::size_t self)
+	{
+		std::size_t seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(wakeMutex);
+				wake.wait(lock, [&] { return stop || generation != seen; });
+				if (stop)
+				{
+					return;
+				}
+				// Read before scanning, so a ParallelFor posted while we scan
+				// wakes us again instead of being missed.
+				seen = generation;
+			}
+			RunAvailable(self);
+		}
+	}
+};
+
+#endif // AOC_THREAD_POOL_H
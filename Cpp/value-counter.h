@@ -0,0 +1,153 @@
+#ifndef AOC_VALUE_COUNTER_H
+#define AOC_VALUE_COUNTER_H
+
+#include <algorithm> // For std::minmax_element
+#include <cstddef>	 // For std::size_t
+#include <cstdint>	 // For int32_t, uint32_t, uint64_t
+#include <vector>	 // For std::vector
+
+/**
+ * @brief Open-addressing hash map from int32_t keys to occurrence counts.
+ * Linear probing over a power-of-two table kept at most half full; a slot
+ * with count 0 is empty, so no separate occupancy array or sentinel key is
+ * needed. Count() never inserts.
+ */
+class FlatCountMap
+{
+public:
+	explicit FlatCountMap(std::size_t expectedKeys = 0)
+	{
+		std::size_t capacity = 16;
+		while (capacity < expectedKeys * 2)
+		{
+			capacity *= 2;
+		}
+		keys.assign(capacity, 0);
+		counts.assign(capacity, 0);
+	}
+
+	void Add(int32_t key, uint32_t times = 1)
+	{
+		if ((used + 1) * 2 > keys.size())
+		{
+			Grow();
+		}
+		std::size_t slot = Find(key);
+		if (counts[slot] == 0)
+		{
+			keys[slot] = key;
+			used++;
+		}
+		counts[slot] += times;
+	}
+
+	uint32_t Count(int32_t key) const { return counts[Find(key)]; }
+
+	std::size_t Size() const { return used; }
+
+private:
+	std::vector<int32_t> keys;
+	std::vector<uint32_t> counts;
+	std::size_t used = 0;
+
+	// Multiplicative (Fibonacci) hashing spreads clustered IDs across the
+	// table; the top bits index it.
+	std::size_t Find(int32_t key) const
+	{
+		std::size_t mask = keys.size() - 1;
+		std::size_t slot = static_cast<std::size_t>(
+							   (static_cast<uint64_t>(static_cast<uint32_t>(key)) *
+								0x9E3779B97F4A7C15ULL) >>
+							   32) &
+						   mask;
+		while (counts[slot] != 0 && keys[slot] != key)
+		{
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	void Grow()
+	{
+		FlatCountMap bigger(keys.size());
+		for (std::size_t i = 0; i < keys.size(); i++)
+		{
+			if (counts[i] != 0)
+			{
+				bigger.Add(keys[i], counts[i]);
+			}
+		}
+		*this = std::move(bigger);
+	}
+};
+
+/**
+ * @brief Occurrence counts of a column of values, for Day1::PartTwo.
+ * When the values span a small range (5-digit IDs span < 10^5) the counts
+ * live in a dense array indexed by value - min: one increment per element to
+ * build, one load per lookup, and the whole table fits in L2. Otherwise it
+ * falls back to a FlatCountMap. Lookups never insert, unlike
+ * std::map::operator[].
+ */
+class ValueCounter
+{
+public:
+	// Largest value range counted densely (4 bytes per possible value).
+	static constexpr uint64_t kMaxDenseRange = uint64_t(1) << 24;
+
+	explicit ValueCounter(const std::vector<int32_t> &values)
+	{
+		if (values.empty())
+		{
+			return;
+		}
+		auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+		uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(*hi) -
+											   static_cast<int64_t>(*lo)) +
+						 1;
+		// Dense only when the table isn't much bigger than the column itself
+		// (or is cache-sized anyway), so sparse columns don't allocate a huge
+		// mostly-empty array.
+		if (range <= kMaxDenseRange &&
+			(range <= 2 * values.size() || range <= (uint64_t(1) << 16)))
+		{
+			dense = true;
+			min = *lo;
+			histogram.assign(static_cast<std::size_t>(range), 0);
+			for (int32_t v : values)
+			{
+				histogram[static_cast<uint32_t>(v - min)]++;
+			}
+		}
+		else
+		{
+			sparse = FlatCountMap(values.size());
+			for (int32_t v : values)
+			{
+				sparse.Add(v);
+			}
+		}
+	}
+
+	uint32_t Count(int32_t key) const
+	{
+		if (dense)
+		{
+			// One unsigned compare covers both key < min and key > max.
+			uint64_t index = static_cast<uint64_t>(static_cast<int64_t>(key) -
+												   static_cast<int64_t>(min));
+			return index < histogram.size() ? histogram[index] : 0;
+		}
+		return sparse.Count(key);
+	}
+
+	bool IsDense() const { return dense; }
+
+private:
+	bool dense = false;
+	int32_t min = 0;
+	std::vector<uint32_t> histogram;
+	FlatCountMap sparse;
+};
+
+#endif // AOC_VALUE_COUNTER_H